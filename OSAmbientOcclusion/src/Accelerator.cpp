@@ -0,0 +1,21 @@
+// Object Space Ambient Occlusion Demo Project
+// (c) 2013 by L.Spiegelberg
+// This code may be redistributed or modified for any learning or teaching purposes
+// but not for any commercial uses
+// to gain further license informations please contact me via
+// spiegelb (at) in.tum.de
+
+#include "Accelerator.h"
+#include "Grid.h"
+#include "BVH.h"
+
+using namespace std;
+
+IAccelerator *createAccelerator(const string& name, const vector<IObject*>& objects, const float cellSize)
+{
+	if(name == "linear")return new LinearAccelerator(objects);
+	if(name == "grid")return new UniformGrid(objects, cellSize);
+	if(name == "bvh")return new BVH(objects);
+
+	return NULL;
+}
\ No newline at end of file
@@ -0,0 +1,141 @@
+// Object Space Ambient Occlusion Demo Project
+// (c) 2013 by L.Spiegelberg
+// This code may be redistributed or modified for any learning or teaching purposes
+// but not for any commercial uses
+// to gain further license informations please contact me via
+// spiegelb (at) in.tum.de
+
+#ifndef ACCELERATOR_HEADER_
+#define ACCELERATOR_HEADER_
+
+#include <vector>
+#include <string>
+
+#include "Ray.h"
+#include "Color.h"
+#include "Objects.h"
+#include "Stats.h"
+
+/// distance reported if a ray hits nothing
+static const float no_hit_distance = 99999.9f;
+
+/// answers ray queries for a list of objects, the objects are not owned
+class IAccelerator
+{
+public:
+	virtual ~IAccelerator()	{}
+
+	/// nearest intersection, fDistance is no_hit_distance and color white if nothing was hit
+	virtual bool intersect(const Ray& r, float& fDistance, Vector& normal, Color& color) = 0;
+
+	/// like intersect, object is set to the nearest object hit
+	virtual bool intersectObject(const Ray& r, float& fDistance, Vector& normal, Color& color, IObject *&object) = 0;
+
+	/// is there any intersection with a distance in (tmin, tmax)? may stop at the first one
+	virtual bool occluded(const Ray& r, const float tmin, const float tmax) = 0;
+
+	/// nearest intersection with a distance in [tmin, tmax), only its distance is returned
+	virtual bool hitDistance(const Ray& r, const float tmin, const float tmax, float& fDistance) = 0;
+};
+
+/// tests every object, no setup cost
+class LinearAccelerator : public IAccelerator
+{
+private:
+	const std::vector<IObject*>& objects;
+
+public:
+	LinearAccelerator(const std::vector<IObject*>& _objects):objects(_objects)	{}
+
+	virtual bool intersect(const Ray& r, float& fDistance, Vector& normal, Color& color)
+	{
+		IObject *object;
+		return intersectObject(r, fDistance, normal, color, object);
+	}
+
+	virtual bool intersectObject(const Ray& r, float& fDistance, Vector& normal, Color& color, IObject *&object)
+	{
+		float fLastDistance = no_hit_distance;
+		color = Color::white;
+		object = NULL;
+		bool intersection = false;
+
+		STATS_ADD(intersectionTests, objects.size());
+
+		for(std::vector<IObject*>::const_iterator it = objects.begin(); it != objects.end(); ++it)
+		{
+			// temp variables
+			Vector _normal;
+			Color _color;
+			if((*it)->intersect(r, fDistance, _normal, _color))
+			{
+				intersection = true;
+
+				// nearer?
+				if(fDistance < fLastDistance)
+				{
+					fLastDistance = fDistance;
+					color = _color;
+					normal = _normal;
+					object = *it;
+				}
+			}
+		}
+
+		fDistance = fLastDistance;
+
+		if(intersection)STATS_ADD(hits, 1);
+
+		return intersection;
+	}
+
+	virtual bool occluded(const Ray& r, const float tmin, const float tmax)
+	{
+		float fDistance;
+		Vector normal;
+		Color color;
+
+		for(std::vector<IObject*>::const_iterator it = objects.begin(); it != objects.end(); ++it)
+		{
+			STATS_ADD(intersectionTests, 1);
+
+			if((*it)->intersect(r, fDistance, normal, color) && fDistance > tmin && fDistance < tmax)
+			{
+				STATS_ADD(hits, 1);
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	virtual bool hitDistance(const Ray& r, const float tmin, const float tmax, float& fDistance)
+	{
+		float dist;
+		Vector normal;
+		Color color;
+
+		bool intersection = false;
+		fDistance = tmax;
+
+		STATS_ADD(intersectionTests, objects.size());
+
+		for(std::vector<IObject*>::const_iterator it = objects.begin(); it != objects.end(); ++it)
+		{
+			if((*it)->intersect(r, dist, normal, color) && dist >= tmin && dist < fDistance)
+			{
+				intersection = true;
+				fDistance = dist;
+			}
+		}
+
+		if(intersection)STATS_ADD(hits, 1);
+
+		return intersection;
+	}
+};
+
+/// accelerator by name(linear, grid, bvh), NULL if unknown
+IAccelerator *createAccelerator(const std::string& name, const std::vector<IObject*>& objects, const float cellSize);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,380 @@
+// Object Space Ambient Occlusion Demo Project
+// (c) 2013 by L.Spiegelberg
+// This code may be redistributed or modified for any learning or teaching purposes
+// but not for any commercial uses
+// to gain further license informations please contact me via
+// spiegelb (at) in.tum.de
+
+#include <algorithm>
+#include <cmath>
+
+#include "main.h"
+#include "AnalyticAO.h"
+
+using namespace std;
+
+const int AnalyticAO::max_resolution;
+
+static const float pi = 3.14159265f;
+
+/// vertices of a clipped face, the rectangle gains at most one vertex per clipping line
+static const int max_vertices = 4 + 1 + AnalyticAO::disk_edges + 1;
+
+static inline float clampf(const float f, const float fmin, const float fmax)	{return min(max(f, fmin), fmax);}
+
+static inline float component(const Vector& v, const int axis)	{return axis == 0 ? v.x : (axis == 1 ? v.y : v.z);}
+
+/// vector with the given components along axis, u and v(the other two axes in cyclic order)
+static inline Vector axisVector(const int axis, const float a, const float u, const float v)
+{
+	if(axis == 0)return Vector(a, u, v);
+	if(axis == 1)return Vector(v, a, u);
+	return Vector(u, v, a);
+}
+
+/// clip a convex polygon to a * u + b * v + c >= 0, returns the new number of vertices
+static int clipPolygon(float poly[][2], const int count, const float a, const float b, const float c)
+{
+	float clipped[max_vertices][2];
+	int n = 0;
+
+	for(int i = 0; i < count; i++)
+	{
+		const float *p0 = poly[i];
+		const float *p1 = poly[(i + 1) % count];
+
+		float f0 = a * p0[0] + b * p0[1] + c;
+		float f1 = a * p1[0] + b * p1[1] + c;
+
+		if(f0 >= 0.0f)
+		{
+			clipped[n][0] = p0[0];
+			clipped[n][1] = p0[1];
+			n++;
+		}
+
+		// edge crosses the line
+		if((f0 >= 0.0f) != (f1 >= 0.0f))
+		{
+			float t = f0 / (f0 - f1);
+			clipped[n][0] = p0[0] + t * (p1[0] - p0[0]);
+			clipped[n][1] = p0[1] + t * (p1[1] - p0[1]);
+			n++;
+		}
+	}
+
+	for(int i = 0; i < n; i++)
+	{
+		poly[i][0] = clipped[i][0];
+		poly[i][1] = clipped[i][1];
+	}
+
+	return n;
+}
+
+/// signed solid angle of a triangle seen from the origin(Van Oosterom and Strackee)
+static float triangleSolidAngle(const Vector& a, const Vector& b, const Vector& c)
+{
+	float la = VectorLength(a);
+	float lb = VectorLength(b);
+	float lc = VectorLength(c);
+
+	Vector bc(b.y * c.z - b.z * c.y, b.z * c.x - b.x * c.z, b.x * c.y - b.y * c.x);
+
+	float numerator = a * bc;
+	float denominator = la * lb * lc + (a * b) * lc + (a * c) * lb + (b * c) * la;
+
+	return 2.0f * atan2(numerator, denominator);
+}
+
+AnalyticAO::AnalyticAO():accel(NULL), radius(1.0f), cellSize(1.0f), invCellSize(1.0f)
+{
+	res[0] = res[1] = res[2] = 0;
+
+	for(int i = 0; i < disk_edges; i++)
+	{
+		float angle = ((float)i + 0.5f) * 2.0f * pi / (float)disk_edges;
+		diskNormals[i][0] = cos(angle);
+		diskNormals[i][1] = sin(angle);
+	}
+}
+
+bool AnalyticAO::build(const vector<IObject*>& objects, const string& accelName, const float aoRadius, const float accelCellSize)
+{
+	spheres.clear();
+	boxes.clear();
+	others.clear();
+	cellStart.clear();
+	cellOccluders.clear();
+	res[0] = res[1] = res[2] = 0;
+
+	delete accel;
+	accel = NULL;
+
+	radius = aoRadius;
+
+	// occluders in the order they are referenced by the cells
+	vector<IObject*> sphereObjects, boxObjects;
+
+	for(vector<IObject*>::const_iterator it = objects.begin(); it != objects.end(); ++it)
+	{
+		if(Sphere *sphere = dynamic_cast<Sphere*>(*it))
+		{
+			SphereOccluder occluder;
+			occluder.center = sphere->getCenter();
+			occluder.radius = sphere->getRadius();
+
+			spheres.push_back(occluder);
+			sphereObjects.push_back(*it);
+		}
+		else if(Box *box = dynamic_cast<Box*>(*it))
+		{
+			BoxOccluder occluder;
+			occluder.vmin = box->getNearPoint();
+			occluder.vmax = box->getFarPoint();
+
+			boxes.push_back(occluder);
+			boxObjects.push_back(*it);
+		}
+		else others.push_back(*it);
+	}
+
+	if(!others.empty())
+	{
+		accel = createAccelerator(accelName, others, accelCellSize);
+		if(!accel)return false;
+	}
+
+	vector<IObject*> analytic(sphereObjects);
+	analytic.insert(analytic.end(), boxObjects.begin(), boxObjects.end());
+
+	if(analytic.empty())return true;
+
+	// grid covers everything within the ao radius of an occluder
+	Vector vmin, vmax;
+	for(unsigned int i = 0; i < analytic.size(); i++)
+	{
+		Vector omin, omax;
+		analytic[i]->getBounds(omin, omax);
+
+		vmin = i ? VectorMin(vmin, omin) : omin;
+		vmax = i ? VectorMax(vmax, omax) : omax;
+	}
+
+	Vector border(radius, radius, radius);
+	bmin = vmin - border;
+	Vector extent = vmax + border - bmin;
+	float longest = max(extent.x, max(extent.y, extent.z));
+
+	// cells as large as the ao radius, so a cell only lists the occluders near it
+	cellSize = max(radius, longest / (float)max_resolution);
+	invCellSize = 1.0f / cellSize;
+
+	res[0] = max(1, min(max_resolution, (int)ceil(extent.x * invCellSize)));
+	res[1] = max(1, min(max_resolution, (int)ceil(extent.y * invCellSize)));
+	res[2] = max(1, min(max_resolution, (int)ceil(extent.z * invCellSize)));
+
+	int count = res[0] * res[1] * res[2];
+
+	// collect occluders per cell, then pack them into one array
+	vector<vector<int> > cells(count);
+
+	for(unsigned int i = 0; i < analytic.size(); i++)
+	{
+		Vector omin, omax;
+		analytic[i]->getBounds(omin, omax);
+		omin = omin - border;
+		omax = omax + border;
+
+		int x0 = max(0, (int)floor((omin.x - bmin.x) * invCellSize)), x1 = min(res[0] - 1, (int)floor((omax.x - bmin.x) * invCellSize));
+		int y0 = max(0, (int)floor((omin.y - bmin.y) * invCellSize)), y1 = min(res[1] - 1, (int)floor((omax.y - bmin.y) * invCellSize));
+		int z0 = max(0, (int)floor((omin.z - bmin.z) * invCellSize)), z1 = min(res[2] - 1, (int)floor((omax.z - bmin.z) * invCellSize));
+
+		for(int z = z0; z <= z1; z++)
+			for(int y = y0; y <= y1; y++)
+				for(int x = x0; x <= x1; x++)
+				{
+					// points of the cell can only be occluded by surfaces within the ao radius of it
+					Vector cmin = bmin + Vector((float)x, (float)y, (float)z) * cellSize - border;
+					Vector cmax = cmin + Vector(cellSize, cellSize, cellSize) + 2.0f * border;
+
+					if(analytic[i]->overlaps(cmin, cmax))cells[cellIndex(x, y, z)].push_back((int)i);
+				}
+	}
+
+	cellStart.resize(count + 1);
+	cellStart[0] = 0;
+	for(int i = 0; i < count; i++)
+	{
+		cellOccluders.insert(cellOccluders.end(), cells[i].begin(), cells[i].end());
+		cellStart[i + 1] = (int)cellOccluders.size();
+	}
+
+	return true;
+}
+
+float AnalyticAO::sphereOcclusion(const SphereOccluder& sphere, const Vector& point, const Vector& normal) const
+{
+	Vector v = sphere.center - point;
+	float d2 = v * v;
+	float r2 = sphere.radius * sphere.radius;
+
+	// a sphere does not occlude its own surface, points inside it are hidden anyway
+	if(d2 <= r2)return 0.0f;
+
+	float d = sqrt(d2);
+	if(d - sphere.radius >= radius)return 0.0f;
+
+	// cone of the directions hitting the sphere. hits get farther from the center of the cone to its border,
+	// if the border is beyond the ao radius the cone ends where the sphere leaves it(law of cosines)
+	float cosCone = sqrt(d2 - r2) / d;
+	if(d2 - r2 > radius * radius)cosCone = (d2 + radius * radius - r2) / (2.0f * d * radius);
+
+	float cone = acos(clampf(cosCone, -1.0f, 1.0f));
+	if(cone <= 0.0f)return 0.0f;
+
+	// part of the cone above the tangent plane, approximated by the part of a disk with the angular
+	// radius of the cone above a line at the elevation of its center
+	float elevation = asin(clampf(normal * v / d, -1.0f, 1.0f));
+	float h = clampf(elevation / cone, -1.0f, 1.0f);
+	float visible = 1.0f - (acos(h) - h * sqrt(1.0f - h * h)) / pi;
+
+	// solid angle of the cone is 2 pi(1 - cos), the hemisphere 2 pi
+	return (1.0f - cosCone) * visible;
+}
+
+float AnalyticAO::boxOcclusion(const BoxOccluder& box, const Vector& point, const Vector& normal) const
+{
+	static const float epsilon = 0.0001f;
+
+	// points on the walls of a box are inside if their normal points into it, like the inside of the room
+	Vector q = point + normal * 0.001f;
+	bool inside = q.x > box.vmin.x && q.x < box.vmax.x && q.y > box.vmin.y && q.y < box.vmax.y && q.z > box.vmin.z && q.z < box.vmax.z;
+
+	float total = 0.0f;
+
+	for(int axis = 0; axis < 3; axis++)
+	{
+		int u = (axis + 1) % 3;
+		int v = (axis + 2) % 3;
+
+		float pa = component(point, axis), pu = component(point, u), pv = component(point, v);
+		float na = component(normal, axis), nu = component(normal, u), nv = component(normal, v);
+		float umin = component(box.vmin, u), umax = component(box.vmax, u);
+		float vmin = component(box.vmin, v), vmax = component(box.vmax, v);
+
+		for(int side = 0; side < 2; side++)
+		{
+			float plane = side ? component(box.vmax, axis) : component(box.vmin, axis);
+
+			// distance to the plane of the face, only faces the point is in front of are hit. from the
+			// inside these are the opposite walls, from the outside the faces turned towards the point
+			float h = side ? pa - plane : plane - pa;
+			if(inside)h = -h;
+			if(h <= epsilon || h >= radius)continue;
+
+			// nearest point of the face
+			float du = pu - clampf(pu, umin, umax);
+			float dv = pv - clampf(pv, vmin, vmax);
+			if(h * h + du * du + dv * dv >= radius * radius)continue;
+
+			// face as polygon in its plane
+			float poly[max_vertices][2] = {{umin, vmin}, {umax, vmin}, {umax, vmax}, {umin, vmax}};
+			int count = 4;
+
+			// tangent plane of the point
+			count = clipPolygon(poly, count, nu, nv, na * (plane - pa) - nu * pu - nv * pv);
+
+			// hits within the ao radius form a disk around the foot of the point, approximated by a polygon
+			// of the same area. not needed if the farthest corner of the face is near enough
+			float fu = max(abs(umin - pu), abs(umax - pu));
+			float fv = max(abs(vmin - pv), abs(vmax - pv));
+
+			if(count >= 3 && h * h + fu * fu + fv * fv > radius * radius)
+			{
+				float disk = sqrt(radius * radius - h * h);
+				float apothem = disk * sqrt(2.0f * pi / ((float)disk_edges * sin(2.0f * pi / (float)disk_edges))) * cos(pi / (float)disk_edges);
+
+				for(int i = 0; i < disk_edges && count >= 3; i++)
+					count = clipPolygon(poly, count, -diskNormals[i][0], -diskNormals[i][1], diskNormals[i][0] * pu + diskNormals[i][1] * pv + apothem);
+			}
+
+			if(count < 3)continue;
+
+			// solid angle of the remaining polygon as a fan of triangles
+			Vector first = axisVector(axis, plane - pa, poly[0][0] - pu, poly[0][1] - pv);
+			float angle = 0.0f;
+
+			for(int i = 1; i + 1 < count; i++)
+			{
+				Vector b = axisVector(axis, plane - pa, poly[i][0] - pu, poly[i][1] - pv);
+				Vector c = axisVector(axis, plane - pa, poly[i + 1][0] - pu, poly[i + 1][1] - pv);
+
+				angle += triangleSolidAngle(first, b, c);
+			}
+
+			total += abs(angle);
+		}
+	}
+
+	return total / (2.0f * pi);
+}
+
+float AnalyticAO::rayOcclusion(const Vector& point, const Vector& normal, const int samples)
+{
+	static const float epsilon = 0.0001f;
+
+	// same directions as computeAO
+	Vector tangent;
+	Vector binormal;
+	hemisphereBasis(normal, tangent, binormal);
+
+	STATS_ADD(aoRays, samples);
+
+	Ray ray(point, Vector());
+	int occluded = 0;
+
+	for(int i = 0; i < samples; i++)
+	{
+		ray.direction = random(-1.0f, 1.0f) * tangent + random(-1.0f, 1.0f) * binormal + random(0.0, 1.0f) * normal;
+		ray.direction.normalize();
+
+		if(accel->occluded(ray, epsilon, radius))occluded++;
+	}
+
+	return (float)occluded / (float)samples;
+}
+
+float AnalyticAO::occlusion(const Vector& point, const Vector& normal, const int samples)
+{
+	float sum = 0.0f;
+
+	if(!cellStart.empty())
+	{
+		// points outside of the grid are farther than the ao radius from every occluder
+		int x = (int)floor((point.x - bmin.x) * invCellSize);
+		int y = (int)floor((point.y - bmin.y) * invCellSize);
+		int z = (int)floor((point.z - bmin.z) * invCellSize);
+
+		if(x >= 0 && y >= 0 && z >= 0 && x < res[0] && y < res[1] && z < res[2])
+		{
+			int cell = cellIndex(x, y, z);
+			int sphereCount = (int)spheres.size();
+
+			// evaluated occluders are counted as intersection tests
+			STATS_ADD(intersectionTests, cellStart[cell + 1] - cellStart[cell]);
+
+			for(int i = cellStart[cell]; i < cellStart[cell + 1] && sum < 1.0f; i++)
+			{
+				int index = cellOccluders[i];
+
+				if(index < sphereCount)sum += sphereOcclusion(spheres[index], point, normal);
+				else sum += boxOcclusion(boxes[index - sphereCount], point, normal);
+			}
+		}
+	}
+
+	if(accel && sum < 1.0f)sum += rayOcclusion(point, normal, samples);
+
+	return min(sum, 1.0f);
+}
\ No newline at end of file
@@ -0,0 +1,98 @@
+// Object Space Ambient Occlusion Demo Project
+// (c) 2013 by L.Spiegelberg
+// This code may be redistributed or modified for any learning or teaching purposes
+// but not for any commercial uses
+// to gain further license informations please contact me via
+// spiegelb (at) in.tum.de
+
+#ifndef ANALYTICAO_HEADER_
+#define ANALYTICAO_HEADER_
+
+#include <vector>
+#include <string>
+
+#include "Objects.h"
+#include "Accelerator.h"
+
+/// ambient occlusion of spheres and boxes in closed form instead of random rays. the occlusion of a point
+/// is the solid angle of the occluders above its tangent plane and within the ao radius, divided by the
+/// solid angle of the hemisphere. contributions of the occluders are summed and clamped to 1.
+/// objects without a closed form(triangles, instances) are sampled with rays like computeAO
+class AnalyticAO
+{
+public:
+	/// edges of the polygon the ao radius is approximated with on a box face
+	static const int disk_edges = 16;
+
+private:
+	struct SphereOccluder
+	{
+		Vector	center;
+		float	radius;
+	};
+
+	struct BoxOccluder
+	{
+		Vector	vmin;
+		Vector	vmax;
+	};
+
+	std::vector<SphereOccluder>	spheres;
+	std::vector<BoxOccluder>	boxes;
+
+	/// objects sampled with rays and the structure they are traced with, NULL if there are none
+	std::vector<IObject*>	others;
+	IAccelerator			*accel;
+
+	float	radius;
+
+	/// outward normals of the edges of the ao radius polygon
+	float	diskNormals[disk_edges][2];
+
+	// cells over the analytic occluders, a cell lists the occluders whose surface is within the ao radius of it.
+	// spheres are referenced by their index, boxes by their index + spheres.size()
+	Vector	bmin;
+	float	cellSize;
+	float	invCellSize;
+	int		res[3];
+
+	/// occluders of cell i are cellOccluders[cellStart[i]] to cellOccluders[cellStart[i + 1] - 1]
+	std::vector<int>	cellStart;
+	std::vector<int>	cellOccluders;
+
+	inline int cellIndex(const int x, const int y, const int z) const	{return x + res[0] * (y + res[1] * z);}
+
+	/// fraction of the hemisphere a sphere occludes
+	float sphereOcclusion(const SphereOccluder& sphere, const Vector& point, const Vector& normal) const;
+
+	/// fraction of the hemisphere a box occludes
+	float boxOcclusion(const BoxOccluder& box, const Vector& point, const Vector& normal) const;
+
+	/// fraction of samples rays blocked by the objects without closed form
+	float rayOcclusion(const Vector& point, const Vector& normal, const int samples);
+
+	// no copies, the accelerator is owned
+	AnalyticAO(const AnalyticAO&);
+	AnalyticAO& operator = (const AnalyticAO&);
+
+public:
+	/// cells along the longest axis at most
+	static const int max_resolution = 64;
+
+	AnalyticAO();
+
+	~AnalyticAO()	{delete accel;}
+
+	/// sort spheres and boxes into cells, other objects go into an accelerator of type accelName(see createAccelerator).
+	/// objects are not owned, returns false if the accelerator is unknown
+	bool build(const std::vector<IObject*>& objects, const std::string& accelName, const float aoRadius, const float accelCellSize);
+
+	/// fraction of the hemisphere around normal that is occluded within the ao radius, samples rays are
+	/// traced for the objects without closed form
+	float occlusion(const Vector& point, const Vector& normal, const int samples);
+
+	inline int getAnalyticCount() const	{return (int)(spheres.size() + boxes.size());}
+	inline int getRayCount() const	{return (int)others.size();}
+};
+
+#endif
\ No newline at end of file
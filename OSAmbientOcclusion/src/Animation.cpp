@@ -0,0 +1,140 @@
+// Object Space Ambient Occlusion Demo Project
+// (c) 2013 by L.Spiegelberg
+// This code may be redistributed or modified for any learning or teaching purposes
+// but not for any commercial uses
+// to gain further license informations please contact me via
+// spiegelb (at) in.tum.de
+
+#include <cstdio>
+#include <sstream>
+
+#include "main.h"
+#include "Animation.h"
+#include "Temporal.h"
+#include "CompressedTileOutput.h"
+
+using namespace std;
+
+/// camera position and target of a key frame
+struct KeyFrame
+{
+	Vector position;
+	Vector lookAt;
+};
+
+static bool readCameraPath(const string& filename, vector<KeyFrame>& keys)
+{
+	ifstream file(filename.c_str());
+	if(!file)
+	{
+		cout<<"could not open camera path "<<filename<<endl;
+		return false;
+	}
+
+	string line;
+	while(getline(file, line))
+	{
+		// skip empty lines and comments
+		if(line.find_first_not_of(" \t\r") == string::npos || line[line.find_first_not_of(" \t\r")] == '#')continue;
+
+		istringstream in(line);
+		KeyFrame key;
+		if(!(in>>key.position>>key.lookAt))
+		{
+			cout<<"malformed key frame "<<line<<endl;
+			return false;
+		}
+
+		keys.push_back(key);
+	}
+
+	if(keys.empty())
+	{
+		cout<<"camera path "<<filename<<" has no key frames"<<endl;
+		return false;
+	}
+
+	return true;
+}
+
+/// camera of a frame, key frames are spread evenly over all frames
+static KeyFrame interpolate(const vector<KeyFrame>& keys, const int frame, const int frames)
+{
+	if(keys.size() == 1 || frames == 1)return keys[0];
+
+	float t = (float)frame / (float)(frames - 1) * (float)(keys.size() - 1);
+	int i = min((int)t, (int)keys.size() - 2);
+	float f = t - (float)i;
+
+	KeyFrame res;
+	res.position = keys[i].position * (1.0f - f) + keys[i + 1].position * f;
+	res.lookAt = keys[i].lookAt * (1.0f - f) + keys[i + 1].lookAt * f;
+
+	return res;
+}
+
+bool RunAnimation(const std::string& filename)
+{
+	vector<KeyFrame> keys;
+	if(!readCameraPath(filename, keys))return false;
+
+	// same lens as the demo camera
+	static const float fovy = 3.14159f / 3.2f;
+
+	TemporalAO temporal;
+	double totalTime = 0.0;
+
+	for(int frame = 0; frame < g_options.frames; frame++)
+	{
+		KeyFrame key = interpolate(keys, frame, g_options.frames);
+		g_camera.setPositionAndLookAt(fovy, key.position, key.lookAt, Vector(0, 1, 0), g_width, g_height);
+
+		Timer timer;
+		{
+			STATS_TIMER(PASS_FRAME);
+			TRACE_SCOPE("frame", "frame");
+
+			Raytrace();
+
+			if(g_options.reprojection)temporal.render(g_GBuffer, g_camera, g_aopass, g_options.aoSamples, g_options.temporalStep, g_options.threads);
+			else AmbientOcclusionPass();
+
+			CompositePass();
+		}
+		double time = timer.elapsed();
+		totalTime += time;
+
+		// file name of the frame, the pattern was checked with isFramePattern
+		char name[1024];
+		int length = snprintf(name, sizeof(name), g_options.output.c_str(), frame);
+		if(length < 0 || length >= (int)sizeof(name))
+		{
+			cout<<"output pattern too long"<<endl;
+			return false;
+		}
+
+		ITileOutput *output = createTileOutput(name);
+		bool written = output->begin(g_width, g_height);
+		if(written)
+		{
+			output->writeTile(Tile(0, 0, g_width, g_height), g_final);
+			written = output->end();
+		}
+		delete output;
+
+		if(!written)return false;
+
+		cout<<"frame "<<frame<<": "<<time * 1000.0<<" ms";
+		if(g_options.reprojection)
+		{
+			double pixels = (double)(g_width * g_height);
+			cout<<", reused "<<100.0 * (double)temporal.getReusedPixels() / pixels<<"% of the pixels, "
+				<<(double)temporal.getNewSamples() / pixels<<" ao samples/pixel";
+		}
+		cout<<endl;
+	}
+
+	cout<<g_options.frames<<" frames in "<<totalTime<<" s, "<<totalTime * 1000.0 / (double)g_options.frames<<" ms/frame"<<endl;
+
+	return true;
+}
\ No newline at end of file
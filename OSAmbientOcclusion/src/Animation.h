@@ -0,0 +1,20 @@
+// Object Space Ambient Occlusion Demo Project
+// (c) 2013 by L.Spiegelberg
+// This code may be redistributed or modified for any learning or teaching purposes
+// but not for any commercial uses
+// to gain further license informations please contact me via
+// spiegelb (at) in.tum.de
+
+#ifndef ANIMATION_HEADER_
+#define ANIMATION_HEADER_
+
+#include <string>
+
+// an animation moves the camera through the current scene. the camera path is a text file
+// with one key frame "<position> <lookat>" per line, g_options.frames frames are interpolated
+// linearly between the key frames and written to files named after the g_options.output pattern
+
+/// render all frames of the camera path in filename, returns false if the path could not be read
+bool RunAnimation(const std::string& filename);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,102 @@
+// Object Space Ambient Occlusion Demo Project
+// (c) 2013 by L.Spiegelberg
+// This code may be redistributed or modified for any learning or teaching purposes
+// but not for any commercial uses
+// to gain further license informations please contact me via
+// spiegelb (at) in.tum.de
+
+#include "main.h"
+#include "AsyncTileOutput.h"
+
+AsyncTileOutput::AsyncTileOutput(ITileOutput *_output):output(_output), first(0), count(0), stop(false)
+{
+	thread = boost::thread(boost::bind(&AsyncTileOutput::work, this));
+}
+
+AsyncTileOutput::~AsyncTileOutput()
+{
+	end();
+
+	{
+		boost::mutex::scoped_lock lock(mutex);
+		stop = true;
+		cond.notify_all();
+	}
+
+	thread.join();
+
+	delete output;
+}
+
+void AsyncTileOutput::work()
+{
+	setTraceThreadName("output");
+
+	boost::mutex::scoped_lock lock(mutex);
+
+	while(true)
+	{
+		while(!count && !stop)cond.wait(lock);
+
+		if(!count)return;
+
+		// the slot stays queued until the tile is written, so writers do not reuse it
+		lock.unlock();
+		{
+			TRACE_SCOPE("write tile", "output");
+			output->writeTile(tiles[first], images[first]);
+		}
+		lock.lock();
+
+		first = (first + 1) % max_queued;
+		count--;
+
+		cond.notify_all();
+	}
+}
+
+void AsyncTileOutput::flush()
+{
+	boost::mutex::scoped_lock lock(mutex);
+
+	while(count)cond.wait(lock);
+}
+
+bool AsyncTileOutput::begin(const int width, const int height)
+{
+	flush();
+
+	return output->begin(width, height);
+}
+
+void AsyncTileOutput::writeTile(const Tile& tile, Image& img)
+{
+	boost::mutex::scoped_lock lock(mutex);
+
+	// back pressure if the disk is slower than the renderer
+	if(count == max_queued)
+	{
+		TRACE_SCOPE("output queue full", "lock");
+		while(count == max_queued)cond.wait(lock);
+	}
+
+	int slot = (first + count) % max_queued;
+
+	// copy under the lock, the I/O thread only needs it between two tiles
+	Image& copy = images[slot];
+	copy.create(tile.width, tile.height);
+	for(int y = 0; y < tile.height; y++)
+		for(int x = 0; x < tile.width; x++)copy.setPixel(x, y, img.getPixel(x, y));
+
+	tiles[slot] = tile;
+	count++;
+
+	cond.notify_all();
+}
+
+bool AsyncTileOutput::end()
+{
+	flush();
+
+	return output->end();
+}
\ No newline at end of file
@@ -0,0 +1,62 @@
+// Object Space Ambient Occlusion Demo Project
+// (c) 2013 by L.Spiegelberg
+// This code may be redistributed or modified for any learning or teaching purposes
+// but not for any commercial uses
+// to gain further license informations please contact me via
+// spiegelb (at) in.tum.de
+
+#ifndef ASYNCTILEOUTPUT_HEADER_
+#define ASYNCTILEOUTPUT_HEADER_
+
+#include <boost/thread.hpp>
+
+#include "TileOutput.h"
+
+/// passes tiles to another output on an own I/O thread, so encoding and writing overlap with rendering.
+/// writeTile only copies the tile into a queue slot and may be called from any thread, it blocks only
+/// if max_queued tiles are waiting. begin and end wait until all queued tiles are written
+class AsyncTileOutput : public ITileOutput
+{
+public:
+	/// tiles waiting for the I/O thread at most
+	static const int max_queued = 16;
+
+private:
+	/// output the tiles are written to, owned
+	ITileOutput		*output;
+
+	/// ring buffer of queued tiles, the images keep their buffers between tiles
+	Tile			tiles[max_queued];
+	Image			images[max_queued];
+	int				first;
+	int				count;
+
+	bool			stop;
+
+	boost::mutex				mutex;
+	boost::condition_variable	cond;
+	boost::thread				thread;
+
+	void work();
+
+	/// wait until all queued tiles are written
+	void flush();
+
+	// no copies
+	AsyncTileOutput(const AsyncTileOutput&);
+	AsyncTileOutput& operator = (const AsyncTileOutput&);
+
+public:
+	/// takes ownership of _output
+	AsyncTileOutput(ITileOutput *_output);
+
+	~AsyncTileOutput();
+
+	bool begin(const int width, const int height);
+
+	void writeTile(const Tile& tile, Image& img);
+
+	bool end();
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,367 @@
+// Object Space Ambient Occlusion Demo Project
+// (c) 2013 by L.Spiegelberg
+// This code may be redistributed or modified for any learning or teaching purposes
+// but not for any commercial uses
+// to gain further license informations please contact me via
+// spiegelb (at) in.tum.de
+
+#include <algorithm>
+
+#include "BVH.h"
+
+using namespace std;
+
+// number of bins for the surface area heuristic
+static const int sah_bins = 12;
+
+// below this depth nodes are split at the median so the traversal stack can not overflow
+static const int max_sah_depth = 40;
+static const int stack_size = 128;
+
+static inline float component(const Vector& v, const int axis)
+{
+	return axis == 0 ? v.x : (axis == 1 ? v.y : v.z);
+}
+
+static inline float surfaceArea(const Vector& vmin, const Vector& vmax)
+{
+	Vector e = vmax - vmin;
+
+	return 2.0f * (e.x * e.y + e.y * e.z + e.z * e.x);
+}
+
+/// is the center of an object in one of the first bins?
+struct BinBelow
+{
+	const vector<Vector>& centers;
+	int axis;
+	float axisMin;
+	float scale;
+	int lastBin;
+
+	BinBelow(const vector<Vector>& _centers, const int _axis, const float _axisMin, const float _scale, const int _lastBin):
+		centers(_centers), axis(_axis), axisMin(_axisMin), scale(_scale), lastBin(_lastBin)	{}
+
+	bool operator () (const int o) const
+	{
+		return min(sah_bins - 1, (int)((component(centers[o], axis) - axisMin) * scale)) <= lastBin;
+	}
+};
+
+/// compares objects by their center along an axis
+struct CenterLess
+{
+	const vector<Vector>& centers;
+	int axis;
+
+	CenterLess(const vector<Vector>& _centers, const int _axis):centers(_centers), axis(_axis)	{}
+
+	bool operator () (const int a, const int b) const
+	{
+		return component(centers[a], axis) < component(centers[b], axis);
+	}
+};
+
+BVH::BVH(const vector<IObject*>& _objects)
+{
+	if(_objects.empty())return;
+
+	vector<Vector> boundsMin(_objects.size()), boundsMax(_objects.size()), centers(_objects.size());
+	vector<int> order(_objects.size());
+
+	for(unsigned int i = 0; i < _objects.size(); i++)
+	{
+		_objects[i]->getBounds(boundsMin[i], boundsMax[i]);
+		centers[i] = (boundsMin[i] + boundsMax[i]) * 0.5f;
+		order[i] = (int)i;
+	}
+
+	nodes.reserve(2 * _objects.size());
+	build(0, (int)_objects.size(), 0, order, boundsMin, boundsMax, centers);
+
+	// leaves reference ranges of the reordered list
+	objects.resize(_objects.size());
+	for(unsigned int i = 0; i < order.size(); i++)objects[i] = _objects[order[i]];
+}
+
+int BVH::build(const int first, const int count, const int depth, vector<int>& order, const vector<Vector>& boundsMin,
+			   const vector<Vector>& boundsMax, const vector<Vector>& centers)
+{
+	int index = (int)nodes.size();
+	nodes.push_back(Node());
+
+	// bounds of objects and of their centers
+	Vector bmin = boundsMin[order[first]], bmax = boundsMax[order[first]];
+	Vector cmin = centers[order[first]], cmax = centers[order[first]];
+
+	for(int i = first + 1; i < first + count; i++)
+	{
+		bmin = VectorMin(bmin, boundsMin[order[i]]);
+		bmax = VectorMax(bmax, boundsMax[order[i]]);
+		cmin = VectorMin(cmin, centers[order[i]]);
+		cmax = VectorMax(cmax, centers[order[i]]);
+	}
+
+	nodes[index].bmin = bmin;
+	nodes[index].bmax = bmax;
+	nodes[index].first = first;
+	nodes[index].count = count;
+	nodes[index].second = 0;
+	nodes[index].axis = 0;
+
+	if(count <= 2)return index;
+
+	// split along the axis with the largest extent of centers
+	Vector extent = cmax - cmin;
+	int axis = extent.x > extent.y ? (extent.x > extent.z ? 0 : 2) : (extent.y > extent.z ? 1 : 2);
+	float axisMin = component(cmin, axis);
+	float axisExtent = component(extent, axis);
+
+	// all centers at the same place, can not split
+	if(axisExtent <= 0.0f)return index;
+
+	int mid = first + count / 2;
+	bool partitioned = false;
+
+	if(depth < max_sah_depth)
+	{
+		// bin objects by center
+		int binCount[sah_bins];
+		Vector binMin[sah_bins], binMax[sah_bins];
+
+		for(int b = 0; b < sah_bins; b++)binCount[b] = 0;
+
+		float scale = (float)sah_bins / axisExtent;
+
+		for(int i = first; i < first + count; i++)
+		{
+			int o = order[i];
+			int b = min(sah_bins - 1, (int)((component(centers[o], axis) - axisMin) * scale));
+
+			if(binCount[b] == 0)
+			{
+				binMin[b] = boundsMin[o];
+				binMax[b] = boundsMax[o];
+			}
+			else
+			{
+				binMin[b] = VectorMin(binMin[b], boundsMin[o]);
+				binMax[b] = VectorMax(binMax[b], boundsMax[o]);
+			}
+			binCount[b]++;
+		}
+
+		// cost of splitting after each bin, sweep from the right first
+		float rightCost[sah_bins];
+		int rightCount = 0;
+		Vector rmin, rmax;
+
+		for(int b = sah_bins - 1; b > 0; b--)
+		{
+			if(binCount[b])
+			{
+				rmin = rightCount ? VectorMin(rmin, binMin[b]) : binMin[b];
+				rmax = rightCount ? VectorMax(rmax, binMax[b]) : binMax[b];
+				rightCount += binCount[b];
+			}
+
+			rightCost[b - 1] = rightCount ? surfaceArea(rmin, rmax) * (float)rightCount : 0.0f;
+		}
+
+		float bestCost = 1e30f;
+		int bestSplit = -1;
+		int leftCount = 0;
+		Vector lmin, lmax;
+
+		for(int b = 0; b < sah_bins - 1; b++)
+		{
+			if(binCount[b])
+			{
+				lmin = leftCount ? VectorMin(lmin, binMin[b]) : binMin[b];
+				lmax = leftCount ? VectorMax(lmax, binMax[b]) : binMax[b];
+				leftCount += binCount[b];
+			}
+
+			if(leftCount == 0 || leftCount == count)continue;
+
+			float cost = surfaceArea(lmin, lmax) * (float)leftCount + rightCost[b];
+			if(cost < bestCost)
+			{
+				bestCost = cost;
+				bestSplit = b;
+			}
+		}
+
+		// traversing a child costs about as much as testing an object
+		float leafCost = surfaceArea(bmin, bmax) * (float)count;
+		bestCost = surfaceArea(bmin, bmax) + bestCost;
+
+		if(bestSplit < 0 || (bestCost >= leafCost && count <= max_leaf_size))
+		{
+			if(count <= max_leaf_size)return index;
+		}
+		else
+		{
+			// partition by bin
+			int *split = partition(&order[first], &order[first] + count, BinBelow(centers, axis, axisMin, scale, bestSplit));
+			mid = (int)(split - &order[0]);
+			partitioned = true;
+		}
+	}
+
+	// median split if SAH was not used or could not separate the objects
+	if(!partitioned)
+		nth_element(order.begin() + first, order.begin() + mid, order.begin() + first + count, CenterLess(centers, axis));
+
+	nodes[index].count = 0;
+	nodes[index].axis = axis;
+
+	build(first, mid - first, depth + 1, order, boundsMin, boundsMax, centers);
+	int second = build(mid, first + count - mid, depth + 1, order, boundsMin, boundsMax, centers);
+
+	nodes[index].second = second;
+
+	return index;
+}
+
+inline bool BVH::hitBox(const Node& node, const Vector& origin, const Vector& invDir, const float tmin, const float tmax)
+{
+	float t0 = (node.bmin.x - origin.x) * invDir.x;
+	float t1 = (node.bmax.x - origin.x) * invDir.x;
+	float enter = min(t0, t1), leave = max(t0, t1);
+
+	t0 = (node.bmin.y - origin.y) * invDir.y;
+	t1 = (node.bmax.y - origin.y) * invDir.y;
+	enter = max(enter, min(t0, t1));
+	leave = min(leave, max(t0, t1));
+
+	t0 = (node.bmin.z - origin.z) * invDir.z;
+	t1 = (node.bmax.z - origin.z) * invDir.z;
+	enter = max(enter, min(t0, t1));
+	leave = min(leave, max(t0, t1));
+
+	return enter <= leave && leave >= tmin && enter < tmax;
+}
+
+bool BVH::traverse(const Ray& r, const float tmin, const float tmax, const bool anyHit, float& fDistance, Vector& normal, Color& color, IObject **object)
+{
+	if(nodes.empty())return false;
+
+	Vector invDir(1.0f / r.direction.x, 1.0f / r.direction.y, 1.0f / r.direction.z);
+
+	int stack[stack_size];
+	int stackSize = 0;
+	int current = 0;
+
+	bool intersection = false;
+	float best = tmax;
+
+	while(true)
+	{
+		const Node& node = nodes[current];
+
+		if(hitBox(node, r.origin, invDir, tmin, best))
+		{
+			if(node.count)
+			{
+				for(int i = node.first; i < node.first + node.count; i++)
+				{
+					STATS_ADD(intersectionTests, 1);
+
+					float dist;
+					Vector n;
+					Color col;
+					if(!objects[i]->intersect(r, dist, n, col))continue;
+
+					if(anyHit)
+					{
+						if(dist > tmin && dist < tmax)
+						{
+							STATS_ADD(hits, 1);
+							return true;
+						}
+					}
+					else if(dist >= tmin && dist < best)
+					{
+						intersection = true;
+						best = dist;
+						normal = n;
+						color = col;
+
+						if(object)*object = objects[i];
+					}
+				}
+			}
+			else
+			{
+				// visit the child in ray direction first
+				int first = current + 1;
+				int second = node.second;
+
+				if(component(r.direction, node.axis) < 0.0f)swap(first, second);
+
+				stack[stackSize++] = second;
+				current = first;
+				continue;
+			}
+		}
+
+		if(stackSize == 0)break;
+		current = stack[--stackSize];
+	}
+
+	if(intersection)
+	{
+		fDistance = best;
+		STATS_ADD(hits, 1);
+	}
+
+	return intersection;
+}
+
+bool BVH::intersect(const Ray& r, float& fDistance, Vector& normal, Color& color)
+{
+	fDistance = no_hit_distance;
+	color = Color::white;
+
+	return traverse(r, 0.0f, no_hit_distance, false, fDistance, normal, color);
+}
+
+bool BVH::intersectObject(const Ray& r, float& fDistance, Vector& normal, Color& color, IObject *&object)
+{
+	fDistance = no_hit_distance;
+	color = Color::white;
+	object = NULL;
+
+	return traverse(r, 0.0f, no_hit_distance, false, fDistance, normal, color, &object);
+}
+
+bool BVH::occluded(const Ray& r, const float tmin, const float tmax)
+{
+	float fDistance;
+	Vector normal;
+	Color color;
+
+	return traverse(r, tmin, tmax, true, fDistance, normal, color);
+}
+
+bool BVH::hitDistance(const Ray& r, const float tmin, const float tmax, float& fDistance)
+{
+	Vector normal;
+	Color color;
+
+	return traverse(r, tmin, tmax, false, fDistance, normal, color);
+}
+
+void BVH::getBounds(Vector& vmin, Vector& vmax) const
+{
+	if(nodes.empty())
+	{
+		vmin = Vector(0.0f, 0.0f, 0.0f);
+		vmax = vmin;
+		return;
+	}
+
+	vmin = nodes[0].bmin;
+	vmax = nodes[0].bmax;
+}
\ No newline at end of file
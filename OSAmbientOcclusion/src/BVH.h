@@ -0,0 +1,69 @@
+// Object Space Ambient Occlusion Demo Project
+// (c) 2013 by L.Spiegelberg
+// This code may be redistributed or modified for any learning or teaching purposes
+// but not for any commercial uses
+// to gain further license informations please contact me via
+// spiegelb (at) in.tum.de
+
+#ifndef BVH_HEADER_
+#define BVH_HEADER_
+
+#include <vector>
+
+#include "Accelerator.h"
+
+/// bounding volume hierarchy over the bounding boxes of objects, built with a binned
+/// surface area heuristic. used as top level structure over the scene(including instances)
+/// and as bottom level structure inside each shared geometry
+class BVH : public IAccelerator
+{
+private:
+	/// node of the flattened tree, children of inner nodes are stored at index + 1 and second
+	struct Node
+	{
+		Vector	bmin;
+		Vector	bmax;
+		int		second;	// inner node: index of second child
+		int		first;	// leaf: first object in objects
+		int		count;	// leaf: number of objects, 0 for inner nodes
+		int		axis;	// inner node: split axis, children are visited in ray direction
+	};
+
+	/// objects per leaf, larger leaves are split if that is cheaper
+	static const int max_leaf_size = 4;
+
+	/// objects reordered so leaves reference contiguous ranges
+	std::vector<IObject*>	objects;
+	std::vector<Node>		nodes;
+
+	/// build node for order[first, first + count), order holds indices into the bounds and centers
+	int build(const int first, const int count, const int depth, std::vector<int>& order, const std::vector<Vector>& boundsMin,
+			  const std::vector<Vector>& boundsMax, const std::vector<Vector>& centers);
+
+	/// ray enters box in [tmin, tmax)?
+	static inline bool hitBox(const Node& node, const Vector& origin, const Vector& invDir, const float tmin, const float tmax);
+
+	/// walk tree, anyHit stops at the first hit in (tmin, tmax)
+	bool traverse(const Ray& r, const float tmin, const float tmax, const bool anyHit, float& fDistance, Vector& normal, Color& color, IObject **object = NULL);
+
+public:
+	BVH(const std::vector<IObject*>& _objects);
+
+	virtual bool intersect(const Ray& r, float& fDistance, Vector& normal, Color& color);
+
+	virtual bool intersectObject(const Ray& r, float& fDistance, Vector& normal, Color& color, IObject *&object);
+
+	virtual bool occluded(const Ray& r, const float tmin, const float tmax);
+
+	virtual bool hitDistance(const Ray& r, const float tmin, const float tmax, float& fDistance);
+
+	/// bounds of all objects, empty BVHs have a degenerated box at the origin
+	void getBounds(Vector& vmin, Vector& vmax) const;
+
+	inline int getNodeCount() const	{return (int)nodes.size();}
+
+	/// memory used by the tree itself
+	inline long long bytes() const	{return (long long)(nodes.size() * sizeof(Node) + objects.size() * sizeof(IObject*));}
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,334 @@
+// Object Space Ambient Occlusion Demo Project
+// (c) 2013 by L.Spiegelberg
+// This code may be redistributed or modified for any learning or teaching purposes
+// but not for any commercial uses
+// to gain further license informations please contact me via
+// spiegelb (at) in.tum.de
+
+#include <algorithm>
+#include <cmath>
+
+#include "main.h"
+#include "Benchmark.h"
+
+using namespace std;
+
+/// seed for scene layout and sampling
+static const unsigned int benchmark_seed = 12345;
+
+/// one measured configuration
+struct BenchmarkResult
+{
+	string	type;
+	int		objects;
+	int		width;
+	int		height;
+	int		samples;
+	int		threads;
+
+	/// median of all runs
+	double	frameTime;
+
+	/// statistics of the median run
+	RenderStats	stats;
+	long long	peakMemory;
+};
+
+/// deterministic random numbers for the scene layout, independent of the render threads
+class SceneRandom
+{
+private:
+	unsigned int state;
+public:
+	SceneRandom(const unsigned int seed):state(seed ? seed : 1)	{}
+
+	float next(const float fmin, const float fmax)
+	{
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+
+		return fmin + ((float)(state >> 8) * (1.0f / 16777216.0f)) * (fmax - fmin);
+	}
+
+	Vector vector(const Vector& vmin, const Vector& vmax)
+	{
+		float x = next(vmin.x, vmax.x);
+		float y = next(vmin.y, vmax.y);
+		float z = next(vmin.z, vmax.z);
+
+		return Vector(x, y, z);
+	}
+
+	Color color()
+	{
+		float r = next(0.2f, 1.0f);
+		float g = next(0.2f, 1.0f);
+		float b = next(0.2f, 1.0f);
+
+		return Color(r, g, b);
+	}
+};
+
+/// low poly sphere of radius 1 around the origin, shared by all instances
+static boost::shared_ptr<Geometry> createBenchmarkGeometry(SceneRandom& rnd)
+{
+	static const int rings = 6;
+	static const int segments = 8;
+	static const float pi = 3.14159265f;
+
+	vector<IObject*> triangles;
+	Color color = rnd.color();
+
+	for(int i = 0; i < rings; i++)
+		for(int j = 0; j < segments; j++)
+		{
+			float theta0 = pi * (float)i / (float)rings, theta1 = pi * (float)(i + 1) / (float)rings;
+			float phi0 = 2.0f * pi * (float)j / (float)segments, phi1 = 2.0f * pi * (float)(j + 1) / (float)segments;
+
+			Vector v00(sin(theta0) * cos(phi0), cos(theta0), sin(theta0) * sin(phi0));
+			Vector v01(sin(theta0) * cos(phi1), cos(theta0), sin(theta0) * sin(phi1));
+			Vector v10(sin(theta1) * cos(phi0), cos(theta1), sin(theta1) * sin(phi0));
+			Vector v11(sin(theta1) * cos(phi1), cos(theta1), sin(theta1) * sin(phi1));
+
+			// the poles only need one triangle
+			if(i > 0)triangles.push_back(new Triangle(v00, v01, v11, color));
+			if(i < rings - 1)triangles.push_back(new Triangle(v00, v11, v10, color));
+		}
+
+	return boost::shared_ptr<Geometry>(new Geometry("blob", triangles));
+}
+
+/// replace scene by count objects of type(sphere, box, triangle, mixed or instance) inside the demo box
+static bool createBenchmarkScene(const string& type, const int count)
+{
+	deleteScene();
+
+	SceneRandom rnd(benchmark_seed);
+
+	// room and light like in the demo scene
+	g_objects.push_back(new Box(Vector(-2, -2, -6), Vector(2, 2, 6.1), Color::white * 0.8f));
+	g_lights.push_back(new AmbientLight(0.9f * Color::yellow));
+
+	// small colored lights spread over the room, each reaching about the same volume
+	if(g_options.benchLights)
+	{
+		float range = 2.0f * pow(4.0f * 4.0f * 12.0f / (float)g_options.benchLights, 1.0f / 3.0f);
+
+		for(int i = 0; i < g_options.benchLights; i++)
+		{
+			Vector pos = rnd.vector(Vector(-1.9f, -1.9f, -5.9f), Vector(1.9f, 1.9f, 6.0f));
+			g_lights.push_back(new PointLight(0.5f * rnd.color(), pos, range));
+		}
+	}
+
+	// objects are placed in front of the camera, their size shrinks
+	// with the count so that they fill about the same volume
+	Vector vmin(-1.8f, -1.8f, -5.8f);
+	Vector vmax(1.8f, 1.8f, -2.5f);
+	Vector extent = vmax - vmin;
+	float size = 0.35f * pow(extent.x * extent.y * extent.z / (float)count, 1.0f / 3.0f);
+
+	static const char *mixed_types[3] = {"sphere", "box", "triangle"};
+
+	boost::shared_ptr<Geometry> geometry;
+	if(type == "instance")geometry = createBenchmarkGeometry(rnd);
+
+	for(int i = 0; i < count; i++)
+	{
+		string t = type == "mixed" ? mixed_types[i % 3] : type;
+
+		Vector center = rnd.vector(vmin, vmax);
+		Color color = rnd.color();
+
+		if(t == "sphere")
+		{
+			g_objects.push_back(new Sphere(size * rnd.next(0.5f, 1.0f), center, color));
+		}
+		else if(t == "box")
+		{
+			Vector half = rnd.vector(Vector(0.5f, 0.5f, 0.5f), Vector(1.0f, 1.0f, 1.0f)) * size;
+			g_objects.push_back(new Box(center - half, center + half, color));
+		}
+		else if(t == "triangle")
+		{
+			Vector v0 = center + rnd.vector(Vector(-1, -1, -1), Vector(1, 1, 1)) * size;
+			Vector v1 = center + rnd.vector(Vector(-1, -1, -1), Vector(1, 1, 1)) * size;
+			Vector v2 = center + rnd.vector(Vector(-1, -1, -1), Vector(1, 1, 1)) * size;
+			g_objects.push_back(new Triangle(v0, v1, v2, color));
+		}
+		else if(t == "instance")
+		{
+			Vector axis = rnd.vector(Vector(-1, -1, -1), Vector(1, 1, 1));
+			Matrix3x3 transform = Matrix3x3::rotation(axis, rnd.next(0.0f, 6.28f)) *
+				Matrix3x3::scale(size, size * rnd.next(0.5f, 1.0f), size);
+			g_objects.push_back(new Instance(geometry, transform, center));
+		}
+		else
+		{
+			cout<<"unknown object type "<<type<<endl;
+			return false;
+		}
+	}
+
+	return buildAccelerators();
+}
+
+static bool compareRuns(const pair<double, RenderStats>& a, const pair<double, RenderStats>& b)
+{
+	return a.first < b.first;
+}
+
+/// seed random generator of pool thread index, every thread gets its own sequence
+static void seedPoolThread(const int index)
+{
+	seedRandom(benchmark_seed + (unsigned int)(index + 1) * 2654435761u);
+}
+
+/// render current scene several times, result holds the median run
+static void measure(BenchmarkResult& result)
+{
+	createImages(result.width, result.height);
+	setupCamera();
+
+	g_options.aoSamples = result.samples;
+	g_options.threads = result.threads;
+
+	vector<pair<double, RenderStats> > runs;
+
+	for(int i = 0; i < g_options.benchRepeat; i++)
+	{
+		// same random numbers for every run, on this thread and on all render threads of the pool
+		srand(benchmark_seed);
+		seedRandom(benchmark_seed);
+		ThreadPool::instance().run(max(ThreadPool::instance().getSize(), g_options.threads), seedPoolThread);
+		resetStats();
+
+		Timer timer;
+		RenderMain();
+		double time = timer.elapsed();
+
+		runs.push_back(make_pair(time, gatherStats()));
+	}
+
+	sort(runs.begin(), runs.end(), compareRuns);
+
+	result.frameTime = runs[runs.size() / 2].first;
+	result.stats = runs[runs.size() / 2].second;
+	result.peakMemory = peakBufferMemory();
+}
+
+static double raysPerSecond(const BenchmarkResult& r)
+{
+	return r.frameTime > 0.0 ? (double)r.stats.rays() / r.frameTime : 0.0;
+}
+
+static double testsPerRay(const BenchmarkResult& r)
+{
+	return r.stats.rays() ? (double)r.stats.intersectionTests / (double)r.stats.rays() : 0.0;
+}
+
+static void writeCSV(ostream& out, const vector<BenchmarkResult>& results)
+{
+	out<<"type,objects,width,height,ao_samples,threads,frame_s,raytrace_s,ao_s,blur_s,composite_s,"
+		<<"rays,rays_per_s,tests_per_ray,peak_memory_bytes"<<endl;
+
+	for(unsigned int i = 0; i < results.size(); i++)
+	{
+		const BenchmarkResult& r = results[i];
+
+		out<<r.type<<","<<r.objects<<","<<r.width<<","<<r.height<<","<<r.samples<<","<<r.threads<<","
+			<<r.frameTime<<","<<r.stats.passMaxTime[PASS_RAYTRACE]<<","<<r.stats.passMaxTime[PASS_AO]<<","
+			<<r.stats.passMaxTime[PASS_BLUR]<<","<<r.stats.passMaxTime[PASS_COMPOSITE]<<","
+			<<r.stats.rays()<<","<<raysPerSecond(r)<<","<<testsPerRay(r)<<","<<r.peakMemory<<endl;
+	}
+}
+
+static void writeJSON(ostream& out, const vector<BenchmarkResult>& results)
+{
+	out<<"{"<<endl
+		<<"  \"hardware_threads\": "<<boost::thread::hardware_concurrency()<<","<<endl
+		<<"  \"repeat\": "<<g_options.benchRepeat<<","<<endl
+		<<"  \"weak_scaling\": "<<(g_options.benchWeak ? "true" : "false")<<","<<endl
+		<<"  \"lights\": "<<g_options.benchLights<<","<<endl
+		<<"  \"light_culling\": "<<(g_options.lightCulling ? "true" : "false")<<","<<endl
+		<<"  \"results\": [";
+
+	for(unsigned int i = 0; i < results.size(); i++)
+	{
+		const BenchmarkResult& r = results[i];
+
+		out<<(i ? "," : "")<<endl
+			<<"    {\"type\": \""<<r.type<<"\", \"objects\": "<<r.objects
+			<<", \"width\": "<<r.width<<", \"height\": "<<r.height
+			<<", \"ao_samples\": "<<r.samples<<", \"threads\": "<<r.threads
+			<<", \"frame_s\": "<<r.frameTime
+			<<", \"raytrace_s\": "<<r.stats.passMaxTime[PASS_RAYTRACE]
+			<<", \"ao_s\": "<<r.stats.passMaxTime[PASS_AO]
+			<<", \"blur_s\": "<<r.stats.passMaxTime[PASS_BLUR]
+			<<", \"composite_s\": "<<r.stats.passMaxTime[PASS_COMPOSITE]
+			<<", \"rays\": "<<r.stats.rays()
+			<<", \"rays_per_s\": "<<raysPerSecond(r)
+			<<", \"tests_per_ray\": "<<testsPerRay(r)
+			<<", \"peak_memory_bytes\": "<<r.peakMemory<<"}";
+	}
+
+	out<<endl<<"  ]"<<endl<<"}"<<endl;
+}
+
+bool RunBenchmark(const std::string& filename)
+{
+#ifndef OSAO_STATS
+	cout<<"benchmark without OSAO_STATS, only frame times are recorded"<<endl;
+#endif
+
+	// copy lists, measure changes g_options
+	const vector<string>	types	= g_options.benchTypes;
+	const vector<int>		objects	= g_options.benchObjects;
+	const vector<int>		sizes	= g_options.benchSizes;
+	const vector<int>		samples	= g_options.benchSamples;
+	const vector<int>		threads	= g_options.benchThreads;
+
+	vector<BenchmarkResult> results;
+
+	for(unsigned int t = 0; t < types.size(); t++)
+		for(unsigned int o = 0; o < objects.size(); o++)
+		{
+			if(!createBenchmarkScene(types[t], objects[o]))return false;
+
+			for(unsigned int s = 0; s < sizes.size(); s++)
+				for(unsigned int k = 0; k < samples.size(); k++)
+					for(unsigned int n = 0; n < threads.size(); n++)
+					{
+						BenchmarkResult r;
+						r.type		= types[t];
+						r.objects	= objects[o];
+						r.samples	= samples[k];
+						r.threads	= threads[n] > 0 ? threads[n] : max(1, (int)boost::thread::hardware_concurrency());
+
+						// weak scaling keeps pixels per thread constant
+						int size = sizes[s];
+						if(g_options.benchWeak)size = (int)(size * sqrt((double)r.threads) + 0.5);
+						r.width = r.height = size;
+
+						measure(r);
+						results.push_back(r);
+
+						cout<<r.type<<" x"<<r.objects<<" "<<r.width<<"x"<<r.height<<" ao "<<r.samples
+							<<" threads "<<r.threads<<": "<<r.frameTime * 1000.0<<" ms, "
+							<<raysPerSecond(r) / 1e6<<" Mrays/s"<<endl;
+					}
+		}
+
+	ofstream file(filename.c_str());
+	if(!file)
+	{
+		cout<<"could not open "<<filename<<" for writing"<<endl;
+		return false;
+	}
+
+	if(filename.size() >= 5 && filename.substr(filename.size() - 5) == ".json")writeJSON(file, results);
+	else writeCSV(file, results);
+
+	return true;
+}
\ No newline at end of file
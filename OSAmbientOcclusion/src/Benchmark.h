@@ -0,0 +1,21 @@
+// Object Space Ambient Occlusion Demo Project
+// (c) 2013 by L.Spiegelberg
+// This code may be redistributed or modified for any learning or teaching purposes
+// but not for any commercial uses
+// to gain further license informations please contact me via
+// spiegelb (at) in.tum.de
+
+#ifndef BENCHMARK_HEADER_
+#define BENCHMARK_HEADER_
+
+#include <string>
+
+// the benchmark renders procedurally generated scenes headless for all combinations of
+// object type, object count, image size, ambient occlusion samples and thread count given
+// in g_options. scenes and sampling are seeded with fixed values so runs are comparable
+
+/// run benchmark and write results to filename(.json writes JSON, anything else CSV)
+/// returns false if the results could not be written
+bool RunBenchmark(const std::string& filename);
+
+#endif
@@ -64,6 +64,7 @@ public:
 
 	void	setPositionAndLookAt(const float fovY, const Vector camPos, const Vector lookAt, const Vector upDir, const int imageWidth, const int imageHeight)
 	{
+		pos = camPos;
 		view = lookAt - camPos;
 		view.normalize();
 
@@ -89,6 +90,43 @@ public:
 
 	}
 
+	/// image position of a point, inverse of getRay. returns false if the point is behind the camera
+	bool	project(const Vector& point, float& fX, float& fY) const
+	{
+		Vector d = point - pos;
+		float z = d * view;
+
+		if(z <= 0.0f)return false;
+
+		float offsetX = (d * right) / z;
+		float offsetY = -(d * up) / z;
+
+		fX = (offsetX / viewPlaneWidth + 0.5f) * width - 0.5f;
+		fY = (offsetY / viewPlaneHeight + 0.5f) * height - 0.5f;
+
+		return true;
+	}
+
+	inline const Vector& getPosition() const	{return pos;}
+
+	/// write camera as one line of a scene description
+	void	write(std::ostream& out)
+	{
+		out<<"camera "<<fovy<<" "<<pos<<" "<<pos + view<<" "<<up<<" "<<(int)width<<" "<<(int)height<<std::endl;
+	}
+
+	/// read camera written with write
+	void	read(std::istream& in)
+	{
+		float fovY;
+		Vector camPos, lookAt, upDir;
+		int imageWidth, imageHeight;
+
+		in>>fovY>>camPos>>lookAt>>upDir>>imageWidth>>imageHeight;
+
+		setPositionAndLookAt(fovY, camPos, lookAt, upDir, imageWidth, imageHeight);
+	}
+
 };
 
 
@@ -88,6 +88,10 @@ inline Color operator + (const Color& a, const Color& b)		{return Color(a.r + b.
 inline Color operator - (const Color& a, const Color& b)		{return Color(a.r - b.r, a.g - b.g, a.b - b.b);}
 inline Color operator - (const Color& c)						{return Color(-c.r, -c.g, -c.b);}
 
+// stream operators, used for scene descriptions
+inline std::ostream& operator << (std::ostream& out, const Color& c)	{return out<<c.r<<" "<<c.g<<" "<<c.b<<" "<<c.a;}
+inline std::istream& operator >> (std::istream& in, Color& c)			{return in>>c.r>>c.g>>c.b>>c.a;}
+
 // Littel Helper for Reordering
 inline unsigned long ARGBToABGR(unsigned long col)
 {
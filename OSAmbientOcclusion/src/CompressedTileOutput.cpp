@@ -0,0 +1,305 @@
+// Object Space Ambient Occlusion Demo Project
+// (c) 2013 by L.Spiegelberg
+// This code may be redistributed or modified for any learning or teaching purposes
+// but not for any commercial uses
+// to gain further license informations please contact me via
+// spiegelb (at) in.tum.de
+
+#include <cstring>
+#include <zlib.h>
+
+#include "main.h"
+#include "CompressedTileOutput.h"
+
+using namespace std;
+
+static const char magic[8] = {'O', 'S', 'A', 'O', 'T', 'L', '1', 0};
+
+// size of the header: magic, width, height, channels, compression, tile count, index offset
+static const int header_size = 8 + 5 * 4 + 8;
+
+// channels per pixel, stored as 32 bit float
+static const int channels = 3;
+
+static inline void put32(unsigned char *p, const unsigned int v)
+{
+	p[0] = (unsigned char)v;
+	p[1] = (unsigned char)(v >> 8);
+	p[2] = (unsigned char)(v >> 16);
+	p[3] = (unsigned char)(v >> 24);
+}
+
+static inline void put64(unsigned char *p, const unsigned long long v)
+{
+	put32(p, (unsigned int)v);
+	put32(p + 4, (unsigned int)(v >> 32));
+}
+
+static inline unsigned int get32(const unsigned char *p)
+{
+	return (unsigned int)p[0] | ((unsigned int)p[1] << 8) | ((unsigned int)p[2] << 16) | ((unsigned int)p[3] << 24);
+}
+
+static inline unsigned long long get64(const unsigned char *p)
+{
+	return (unsigned long long)get32(p) | ((unsigned long long)get32(p + 4) << 32);
+}
+
+bool CompressedTileOutput::begin(const int _width, const int _height)
+{
+	end();
+
+	width = _width;
+	height = _height;
+	index.clear();
+	failed = false;
+
+	file = fopen(filename.c_str(), "wb");
+	if(!file)
+	{
+		cout<<"could not open "<<filename<<" for writing"<<endl;
+		return false;
+	}
+
+	// header, tile count and index offset are filled in by end
+	unsigned char header[header_size];
+	memset(header, 0, sizeof(header));
+	memcpy(header, magic, 8);
+	put32(header + 8, width);
+	put32(header + 12, height);
+	put32(header + 16, channels);
+	put32(header + 20, 1);
+
+	if(fwrite(header, 1, sizeof(header), file) != sizeof(header))
+	{
+		cout<<"could not write "<<filename<<endl;
+		end();
+		return false;
+	}
+
+	position = header_size;
+
+	return true;
+}
+
+void CompressedTileOutput::writeTile(const Tile& tile, Image& img)
+{
+	if(!file)return;
+
+	STATS_TIMER(PASS_OUTPUT);
+	TRACE_SCOPE("write tile", "output");
+
+	// split floats into byte planes
+	const int values = tile.width * tile.height * channels;
+	planes.resize(4 * values);
+
+	int i = 0;
+	for(int y = 0; y < tile.height; y++)
+		for(int x = 0; x < tile.width; x++)
+		{
+			Color c = img.getPixel(x, y);
+			float rgb[channels] = {c.r, c.g, c.b};
+
+			for(int k = 0; k < channels; k++, i++)
+			{
+				unsigned int bits;
+				memcpy(&bits, &rgb[k], 4);
+
+				planes[i]				= (unsigned char)bits;
+				planes[i + values]		= (unsigned char)(bits >> 8);
+				planes[i + 2 * values]	= (unsigned char)(bits >> 16);
+				planes[i + 3 * values]	= (unsigned char)(bits >> 24);
+			}
+		}
+
+	// compress
+	uLongf size = compressBound((uLong)planes.size());
+	compressed.resize(20 + size);
+
+	if(compress2(&compressed[20], &size, &planes[0], (uLong)planes.size(), compression_level) != Z_OK)
+	{
+		cout<<"could not compress tile "<<tile.x<<", "<<tile.y<<endl;
+		failed = true;
+		return;
+	}
+
+	put32(&compressed[0], tile.x);
+	put32(&compressed[4], tile.y);
+	put32(&compressed[8], tile.width);
+	put32(&compressed[12], tile.height);
+	put32(&compressed[16], (unsigned int)size);
+
+	// append
+	if(fwrite(&compressed[0], 1, 20 + size, file) != 20 + size)
+	{
+		cout<<"could not write tile "<<tile.x<<", "<<tile.y<<" to "<<filename<<endl;
+		failed = true;
+		return;
+	}
+
+	IndexEntry entry;
+	entry.tile = tile;
+	entry.offset = position + 20;
+	entry.size = (unsigned int)size;
+	index.push_back(entry);
+
+	position += 20 + size;
+}
+
+bool CompressedTileOutput::writeIndex()
+{
+	vector<unsigned char> data(index.size() * 28);
+
+	for(unsigned int i = 0; i < index.size(); i++)
+	{
+		unsigned char *p = &data[i * 28];
+		put32(p, index[i].tile.x);
+		put32(p + 4, index[i].tile.y);
+		put32(p + 8, index[i].tile.width);
+		put32(p + 12, index[i].tile.height);
+		put64(p + 16, index[i].offset);
+		put32(p + 24, index[i].size);
+	}
+
+	if(!data.empty() && fwrite(&data[0], 1, data.size(), file) != data.size())return false;
+
+	// tile count and index offset in the header
+	unsigned char header[12];
+	put32(header, (unsigned int)index.size());
+	put64(header + 4, position);
+
+	if(fseek64(file, 24))return false;
+
+	return fwrite(header, 1, sizeof(header), file) == sizeof(header);
+}
+
+bool CompressedTileOutput::end()
+{
+	if(!file)return !failed;
+
+	if(!writeIndex())
+	{
+		cout<<"could not write tile index of "<<filename<<endl;
+		failed = true;
+	}
+
+	if(fclose(file))
+	{
+		cout<<"could not write "<<filename<<endl;
+		failed = true;
+	}
+	file = NULL;
+
+	return !failed;
+}
+
+bool readCompressedTiles(const string& filename, Image& img)
+{
+	FILE *file = fopen(filename.c_str(), "rb");
+	if(!file)
+	{
+		cout<<"could not open "<<filename<<endl;
+		return false;
+	}
+
+	unsigned char header[header_size];
+	if(fread(header, 1, sizeof(header), file) != sizeof(header) || memcmp(header, magic, 8) ||
+		get32(header + 16) != channels || get32(header + 20) != 1)
+	{
+		cout<<filename<<" is no compressed tile file"<<endl;
+		fclose(file);
+		return false;
+	}
+
+	const int width = (int)get32(header + 8);
+	const int height = (int)get32(header + 12);
+	const unsigned int count = get32(header + 24);
+
+	if(width <= 0 || height <= 0)
+	{
+		cout<<"invalid image size in "<<filename<<endl;
+		fclose(file);
+		return false;
+	}
+
+	// the index is read as a whole, then each tile is looked up through it
+	vector<unsigned char> data((size_t)count * 28);
+	if(fseek64(file, (long long)get64(header + 28)) || (!data.empty() && fread(&data[0], 1, data.size(), file) != data.size()))
+	{
+		cout<<"could not read tile index of "<<filename<<endl;
+		fclose(file);
+		return false;
+	}
+
+	img.create(width, height);
+
+	// every pixel has to be covered by a tile
+	long long pixels = 0;
+	vector<unsigned char> planes, compressed;
+
+	for(unsigned int t = 0; t < count; t++)
+	{
+		const unsigned char *p = &data[t * 28];
+		Tile tile((int)get32(p), (int)get32(p + 4), (int)get32(p + 8), (int)get32(p + 12));
+		unsigned int size = get32(p + 24);
+
+		if(tile.x < 0 || tile.y < 0 || tile.width <= 0 || tile.height <= 0 || !size || tile.x + tile.width > width || tile.y + tile.height > height)
+		{
+			cout<<"invalid tile "<<tile.x<<", "<<tile.y<<" in "<<filename<<endl;
+			fclose(file);
+			return false;
+		}
+
+		const int values = tile.width * tile.height * channels;
+		planes.resize(4 * values);
+		compressed.resize(size);
+
+		uLongf planeSize = (uLongf)planes.size();
+		if(fseek64(file, (long long)get64(p + 16)) || fread(&compressed[0], 1, size, file) != size ||
+			uncompress(&planes[0], &planeSize, &compressed[0], size) != Z_OK || planeSize != planes.size())
+		{
+			cout<<"could not read tile "<<tile.x<<", "<<tile.y<<" of "<<filename<<endl;
+			fclose(file);
+			return false;
+		}
+
+		// join the byte planes again
+		int i = 0;
+		for(int y = 0; y < tile.height; y++)
+			for(int x = 0; x < tile.width; x++)
+			{
+				float rgb[channels];
+
+				for(int k = 0; k < channels; k++, i++)
+				{
+					unsigned int bits = (unsigned int)planes[i] | ((unsigned int)planes[i + values] << 8) |
+						((unsigned int)planes[i + 2 * values] << 16) | ((unsigned int)planes[i + 3 * values] << 24);
+					memcpy(&rgb[k], &bits, 4);
+				}
+
+				img.setPixel(tile.x + x, tile.y + y, Color(rgb[0], rgb[1], rgb[2]));
+			}
+
+		pixels += (long long)tile.width * tile.height;
+	}
+
+	fclose(file);
+
+	if(pixels < (long long)width * height)
+	{
+		cout<<filename<<" misses tiles"<<endl;
+		return false;
+	}
+
+	return true;
+}
+
+ITileOutput *createTileOutput(const string& filename)
+{
+	const string extension = ".osat";
+
+	if(filename.size() >= extension.size() && filename.compare(filename.size() - extension.size(), extension.size(), extension) == 0)
+		return new CompressedTileOutput(filename);
+
+	return new PPMTileOutput(filename);
+}
\ No newline at end of file
@@ -0,0 +1,77 @@
+// Object Space Ambient Occlusion Demo Project
+// (c) 2013 by L.Spiegelberg
+// This code may be redistributed or modified for any learning or teaching purposes
+// but not for any commercial uses
+// to gain further license informations please contact me via
+// spiegelb (at) in.tum.de
+
+#ifndef COMPRESSEDTILEOUTPUT_HEADER_
+#define COMPRESSEDTILEOUTPUT_HEADER_
+
+#include "TileOutput.h"
+
+// tiled image file with zlib compressed 32 bit float tiles, tiles are appended in the order they are
+// finished and found through an index at the end of the file. layout(little endian):
+//
+//	header	"OSAOTL1\0", width, height, channels(3, rgb), compression(1 = zlib), tile count, index offset(64 bit)
+//	tiles	x, y, width, height, compressed size, zlib data
+//	index	x, y, width, height, offset of the tile(64 bit), compressed size for every tile
+//
+// the float values of a tile are split into byte planes(all first bytes, then all second bytes...) before
+// compressing, neighbouring pixels have similar exponents and compress much better that way
+class CompressedTileOutput : public ITileOutput
+{
+private:
+	/// entry of the tile index
+	struct IndexEntry
+	{
+		Tile		tile;
+		long long	offset;
+		unsigned int size;
+	};
+
+	std::string filename;
+	FILE		*file;
+
+	int width;
+	int height;
+
+	/// end of the written tiles
+	long long	position;
+
+	/// a tile could not be compressed or written, the file misses it
+	bool		failed;
+
+	std::vector<IndexEntry>		index;
+
+	/// byte planes of a tile and their compressed form, reused for all tiles
+	std::vector<unsigned char>	planes;
+	std::vector<unsigned char>	compressed;
+
+	bool writeIndex();
+
+public:
+	/// zlib level, fast levels keep up with the renderer
+	static const int compression_level = 3;
+
+	CompressedTileOutput(const std::string& _filename):filename(_filename), file(NULL), width(0), height(0), position(0), failed(false)	{}
+
+	~CompressedTileOutput()
+	{
+		end();
+	}
+
+	bool begin(const int _width, const int _height);
+
+	void writeTile(const Tile& tile, Image& img);
+
+	bool end();
+};
+
+/// read all tiles of a compressed tile file into img, returns false if the file is damaged or misses tiles
+bool readCompressedTiles(const std::string& filename, Image& img);
+
+/// output for filename, compressed tiles for .osat files and binary PPM otherwise
+ITileOutput *createTileOutput(const std::string& filename);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,114 @@
+// Object Space Ambient Occlusion Demo Project
+// (c) 2013 by L.Spiegelberg
+// This code may be redistributed or modified for any learning or teaching purposes
+// but not for any commercial uses
+// to gain further license informations please contact me via
+// spiegelb (at) in.tum.de
+
+#include <algorithm>
+#include <cstring>
+
+#include "main.h"
+#include "CostMap.h"
+
+using namespace std;
+
+static const char *metric_names[COST_METRICS] = {"time", "rays", "tests"};
+
+const char *costMetricName(const CostMetric metric)
+{
+	return metric_names[metric];
+}
+
+bool parseCostMetric(const string& name, CostMetric& metric)
+{
+	for(int i = 0; i < COST_METRICS; i++)
+		if(name == metric_names[i])
+		{
+			metric = (CostMetric)i;
+			return true;
+		}
+
+	return false;
+}
+
+/// blue, cyan, green, yellow, red for t from 0 to 1
+static Color heatColor(float t)
+{
+	static const float ramp[5][3] = {{0.0f, 0.0f, 1.0f}, {0.0f, 1.0f, 1.0f}, {0.0f, 1.0f, 0.0f}, {1.0f, 1.0f, 0.0f}, {1.0f, 0.0f, 0.0f}};
+
+	t = min(max(t, 0.0f), 1.0f) * 4.0f;
+	int i = min((int)t, 3);
+	float f = t - (float)i;
+
+	return Color(ramp[i][0] + (ramp[i + 1][0] - ramp[i][0]) * f,
+		ramp[i][1] + (ramp[i + 1][1] - ramp[i][1]) * f,
+		ramp[i][2] + (ramp[i + 1][2] - ramp[i][2]) * f);
+}
+
+void CostMap::create(const int _width, const int _height)
+{
+	width = _width;
+	height = _height;
+
+	for(int i = 0; i < COST_METRICS; i++)values[i].assign(width * height, 0.0f);
+}
+
+void CostMap::addTile(const Tile& tile, const CostProbe& start)
+{
+	if(!enabled())return;
+
+	CostProbe now = probe();
+	float weight = 1.0f / (float)(tile.width * tile.height);
+
+	for(int y = tile.y; y < tile.y + tile.height; y++)
+		for(int x = tile.x; x < tile.x + tile.width; x++)addCost(x + y * width, start, now, weight);
+}
+
+void CostMap::toImage(const CostMetric metric, Image& img)
+{
+	img.create(width, height);
+	if(!enabled())return;
+
+	vector<float> sorted(values[metric]);
+	size_t index = sorted.size() * 99 / 100;
+	nth_element(sorted.begin(), sorted.begin() + index, sorted.end());
+
+	scale[metric] = sorted[index];
+	float inv = scale[metric] > 0.0f ? 1.0f / scale[metric] : 0.0f;
+
+	for(int y = 0; y < height; y++)
+		for(int x = 0; x < width; x++)img.setPixel(x, y, heatColor(values[metric][x + y * width] * inv));
+}
+
+void CostMap::printTiles(ostream& out, const CostMetric metric, const int tileSize, const int count) const
+{
+	if(!enabled())return;
+
+	vector<Tile> tiles = generateTiles(width, height, tileSize);
+	vector<pair<double, int> > costs(tiles.size());
+	double total = 0.0;
+
+	for(unsigned int i = 0; i < tiles.size(); i++)
+	{
+		const Tile& tile = tiles[i];
+		double sum = 0.0;
+
+		for(int y = tile.y; y < tile.y + tile.height; y++)
+			for(int x = tile.x; x < tile.x + tile.width; x++)sum += values[metric][x + y * width];
+
+		costs[i] = make_pair(sum, (int)i);
+		total += sum;
+	}
+
+	sort(costs.rbegin(), costs.rend());
+
+	out<<"most expensive tiles by "<<metric_names[metric]<<"(total "<<total<<"):"<<endl;
+	for(int i = 0; i < min(count, (int)costs.size()); i++)
+	{
+		const Tile& tile = tiles[costs[i].second];
+
+		out<<"  tile("<<tile.x<<", "<<tile.y<<") "<<tile.width<<"x"<<tile.height<<": "<<costs[i].first
+			<<"("<<(total > 0.0 ? 100.0 * costs[i].first / total : 0.0)<<"%)"<<endl;
+	}
+}
\ No newline at end of file
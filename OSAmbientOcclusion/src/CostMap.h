@@ -0,0 +1,122 @@
+// Object Space Ambient Occlusion Demo Project
+// (c) 2013 by L.Spiegelberg
+// This code may be redistributed or modified for any learning or teaching purposes
+// but not for any commercial uses
+// to gain further license informations please contact me via
+// spiegelb (at) in.tum.de
+
+#ifndef COSTMAP_HEADER_
+#define COSTMAP_HEADER_
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Image.h"
+#include "Tiles.h"
+#include "Stats.h"
+
+// render cost of every pixel, shown as a false color heatmap(F9 - F11) or written next to the output.
+// the passes take a probe before working on a pixel and add the difference afterwards, so a pixel holds
+// the sum over the raytrace and ambient occlusion passes. passes working on whole tiles at once(--ao-scale,
+// --wavefront) spread the cost of a tile evenly over its pixels. rays and intersection tests are taken
+// from the render statistics and are only counted if OSAO_STATS is defined
+
+/// measured costs
+enum CostMetric
+{
+	COST_TIME = 0,	// seconds
+	COST_RAYS,		// camera, antialiasing and ambient occlusion rays
+	COST_TESTS,		// ray object intersection tests
+	COST_METRICS
+};
+
+/// counters of the calling thread at some point
+struct CostProbe
+{
+	double				time;
+	unsigned long long	rays;
+	unsigned long long	tests;
+
+	CostProbe():time(0.0), rays(0), tests(0)	{}
+};
+
+class CostMap
+{
+private:
+	/// cost of each pixel, row by row
+	std::vector<float>	values[COST_METRICS];
+
+	int					width;
+	int					height;
+
+	/// value shown as the hottest color, set by toImage
+	float				scale[COST_METRICS];
+
+	void addCost(const int index, const CostProbe& start, const CostProbe& now, const float weight)
+	{
+		values[COST_TIME][index] += (float)(now.time - start.time) * weight;
+		values[COST_RAYS][index] += (float)(now.rays - start.rays) * weight;
+		values[COST_TESTS][index] += (float)(now.tests - start.tests) * weight;
+	}
+
+public:
+	CostMap():width(0), height(0)
+	{
+		for(int i = 0; i < COST_METRICS; i++)scale[i] = 0.0f;
+	}
+
+	/// start recording, all costs are zero
+	void create(const int _width, const int _height);
+
+	/// is cost recorded at all
+	inline bool enabled() const	{return width > 0;}
+
+	/// counters of the calling thread, nothing is measured if the map is not enabled
+	inline CostProbe probe() const
+	{
+		CostProbe res;
+		if(!enabled())return res;
+
+		res.time = getTime();
+#ifdef OSAO_STATS
+		const RenderStats& stats = localStats();
+		res.rays = stats.rays();
+		res.tests = stats.intersectionTests;
+#endif
+		return res;
+	}
+
+	/// add the cost since start to pixel(x, y). every pixel is worked on by one thread at a time,
+	/// so no lock is needed. the costs may only be read once all render threads are done
+	inline void add(const int x, const int y, const CostProbe& start)
+	{
+		if(!enabled())return;
+
+		addCost(x + y * width, start, probe(), 1.0f);
+	}
+
+	/// add the cost since start spread evenly over the pixels of a tile
+	void addTile(const Tile& tile, const CostProbe& start);
+
+	/// cost of a pixel
+	inline float get(const CostMetric metric, const int x, const int y) const	{return values[metric][x + y * width];}
+
+	/// false color image of a metric, blue is cheap and red expensive. the 99th percentile is shown
+	/// red, so a few outliers do not make the rest of the image blue
+	void toImage(const CostMetric metric, Image& img);
+
+	/// value shown red in the last image of the metric
+	inline float getScale(const CostMetric metric) const	{return scale[metric];}
+
+	/// print the count most expensive tiles of tileSize and their share of the total cost
+	void printTiles(std::ostream& out, const CostMetric metric, const int tileSize, const int count) const;
+};
+
+/// name of a metric, used on the command line and for output files
+const char *costMetricName(const CostMetric metric);
+
+/// metric of a name, returns false if the name is unknown
+bool parseCostMetric(const std::string& name, CostMetric& metric);
+
+#endif
\ No newline at end of file
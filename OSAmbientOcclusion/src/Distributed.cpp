@@ -0,0 +1,382 @@
+// Object Space Ambient Occlusion Demo Project
+// (c) 2013 by L.Spiegelberg
+// This code may be redistributed or modified for any learning or teaching purposes
+// but not for any commercial uses
+// to gain further license informations please contact me via
+// spiegelb (at) in.tum.de
+
+#include <boost/asio.hpp>
+#include <boost/bind.hpp>
+#include <boost/shared_ptr.hpp>
+#include <deque>
+
+#include "main.h"
+#include "Distributed.h"
+#include "SocketIO.h"
+
+using namespace std;
+using boost::asio::ip::tcp;
+
+// protocol, all values are sent in host byte order(coordinator and workers need the same architecture)
+//	coordinator -> worker:	magic, image width, image height, length of scene description, length of settings
+//							followed by the scene description(see SceneIO.h) and the render settings
+//							(command line options, see writeSettings)
+//	coordinator -> worker:	tile(x, y, width, height), a tile with width 0 ends the session
+//	worker -> coordinator:	the same tile followed by the antialiased color(r, g, b floats)
+//							and the ambient occlusion including the blur border(one float per pixel)
+
+static const int protocol_magic = 0x4f53414f;
+
+/// seconds a worker may take for a tile, after that it is disconnected and the tile is handed out again
+static const int tile_timeout = 120;
+
+/// settings of the coordinator that change the rendered tiles, as command line options for the workers
+static string writeSettings()
+{
+	stringstream ss;
+	ss.precision(9);
+
+	ss<<"--ao-samples "<<g_options.aoSamples<<" --ao-radius "<<g_options.aoRadius
+		<<" --primary-accel "<<g_options.primaryAccel<<" --ao-accel "<<g_options.aoAccel<<" --grid-cell "<<g_options.gridCellScale
+		<<" --ao-method "<<g_options.aoMethod<<" --surfel-size "<<g_options.surfelSize<<" --surfel-error "<<g_options.surfelError
+		<<" --aa "<<g_options.aaGrid<<" --blur-size "<<g_options.blurSize;
+
+	if(!g_options.lightCulling)ss<<" --no-light-culling";
+
+	return ss.str();
+}
+
+/// apply settings written by writeSettings on top of the own options, returns false if they are invalid
+static bool readSettings(const string& settings)
+{
+	vector<string> words(1, "worker");
+	istringstream in(settings);
+	string word;
+	while(in>>word)words.push_back(word);
+
+	vector<char*> argv;
+	for(unsigned int i = 0; i < words.size(); i++)argv.push_back(&words[i][0]);
+
+	RenderOptions options = g_options;
+	if(!parseOptions((int)argv.size(), &argv[0], options))return false;
+
+	g_options = options;
+	Image::blurSize() = g_options.blurSize;
+
+	return true;
+}
+
+/// tiles which still need to be rendered
+class TileQueue
+{
+private:
+	boost::mutex				mutex;
+	boost::condition_variable	cond;
+
+	/// tiles not handed out yet
+	deque<int>	pending;
+
+	/// tiles not finished yet(pending or in flight)
+	int			remaining;
+
+public:
+	TileQueue(const int count):remaining(count)
+	{
+		for(int i = 0; i < count; i++)pending.push_back(i);
+	}
+
+	/// get next tile, waits while all unfinished tiles are in flight(they might be given back)
+	/// returns false if all tiles are finished
+	bool pop(int& index)
+	{
+		boost::mutex::scoped_lock lock(mutex);
+
+		while(pending.empty() && remaining > 0)cond.wait(lock);
+
+		if(remaining == 0)return false;
+
+		index = pending.front();
+		pending.pop_front();
+
+		return true;
+	}
+
+	/// tile could not be rendered, hand it out again
+	void giveBack(const int index)
+	{
+		boost::mutex::scoped_lock lock(mutex);
+
+		pending.push_front(index);
+		cond.notify_one();
+	}
+
+	/// tile is done
+	void finish()
+	{
+		boost::mutex::scoped_lock lock(mutex);
+
+		remaining--;
+		if(remaining == 0)cond.notify_all();
+	}
+
+	/// wait till all tiles are done
+	void wait()
+	{
+		boost::mutex::scoped_lock lock(mutex);
+
+		while(remaining > 0)cond.wait(lock);
+	}
+};
+
+/// accepts workers and serves each of them in its own thread
+class Coordinator
+{
+private:
+	boost::asio::io_service	io;
+	tcp::acceptor			acceptor;
+
+	/// scene description and render settings sent to all workers
+	string					scene;
+	string					settings;
+
+	vector<Tile>			tiles;
+	TileQueue				queue;
+
+	ITileOutput&			output;
+	boost::mutex			output_mutex;
+
+	boost::thread_group		workers;
+
+	/// disconnect a worker that did not return its tile in time, its blocking receive fails then
+	void handleTimeout(boost::shared_ptr<tcp::socket> socket, const string& name, const boost::system::error_code& ec)
+	{
+		if(ec)return;
+
+		cout<<"worker "<<name<<" timed out"<<endl;
+
+		boost::system::error_code ignored;
+		socket->shutdown(tcp::socket::shutdown_both, ignored);
+	}
+
+	void accept()
+	{
+		boost::shared_ptr<tcp::socket> socket(new tcp::socket(io));
+
+		acceptor.async_accept(*socket, boost::bind(&Coordinator::handleAccept, this, socket, boost::asio::placeholders::error));
+	}
+
+	void handleAccept(boost::shared_ptr<tcp::socket> socket, const boost::system::error_code& ec)
+	{
+		if(!ec)workers.create_thread(boost::bind(&Coordinator::serve, this, socket));
+
+		accept();
+	}
+
+	/// hand out tiles to a single worker
+	void serve(boost::shared_ptr<tcp::socket> socket)
+	{
+		boost::system::error_code ec;
+		string name = socket->remote_endpoint(ec).address().to_string(ec);
+
+		cout<<"worker "<<name<<" connected"<<endl;
+
+		// send scene and settings
+		int header[5] = {protocol_magic, g_width, g_height, (int)scene.size(), (int)settings.size()};
+		if(!send(*socket, header, 5) || !send(*socket, scene.data(), scene.size()) || !send(*socket, settings.data(), settings.size()))
+		{
+			cout<<"lost worker "<<name<<endl;
+			return;
+		}
+
+		const int border = Image::blurSize() / 2;
+		TileBuffers buffers;
+		int index;
+
+		while(queue.pop(index))
+		{
+			const Tile& tile = tiles[index];
+
+			// send tile, receive results
+			int msg[4] = {tile.x, tile.y, tile.width, tile.height};
+			int reply[4];
+
+			buffers.resize(tile.width, tile.height, border);
+
+			// runs on the acceptor thread
+			boost::asio::deadline_timer timer(io, boost::posix_time::seconds(tile_timeout));
+			timer.async_wait(boost::bind(&Coordinator::handleTimeout, this, socket, name, boost::asio::placeholders::error));
+
+			bool received = send(*socket, msg, 4) && receive(*socket, reply, 4) &&
+				reply[0] == tile.x && reply[1] == tile.y && reply[2] == tile.width && reply[3] == tile.height &&
+				receiveImage(*socket, buffers.image, 3) && receiveImage(*socket, buffers.aopass, 1);
+
+			timer.cancel();
+
+			if(!received)
+			{
+				cout<<"lost worker "<<name<<", tile "<<index<<" will be rendered again"<<endl;
+				queue.giveBack(index);
+				return;
+			}
+
+			CompositeTile(tile, buffers);
+
+			traceLock(output_mutex, "output_mutex");
+			output.writeTile(tile, buffers.final);
+			output_mutex.unlock();
+
+			queue.finish();
+		}
+
+		// no work left
+		int msg[4] = {0, 0, 0, 0};
+		send(*socket, msg, 4);
+
+		cout<<"worker "<<name<<" finished"<<endl;
+	}
+
+	void runAcceptor()
+	{
+		io.run();
+	}
+
+public:
+	Coordinator(ITileOutput& _output):acceptor(io), tiles(generateTiles(g_width, g_height, g_options.tileSize)),
+		queue((int)tiles.size()), output(_output)
+	{
+		stringstream ss;
+		writeScene(ss, g_camera, g_objects, g_lights);
+		scene = ss.str();
+
+		settings = writeSettings();
+	}
+
+	/// render all tiles, returns false if they could not be written
+	bool run(const unsigned short port)
+	{
+		boost::system::error_code ec;
+		tcp::endpoint endpoint(tcp::v4(), port);
+
+		acceptor.open(endpoint.protocol(), ec);
+		if(!ec)acceptor.set_option(tcp::acceptor::reuse_address(true), ec);
+		if(!ec)acceptor.bind(endpoint, ec);
+		if(!ec)acceptor.listen(boost::asio::socket_base::max_connections, ec);
+
+		if(ec)
+		{
+			cout<<"could not listen on port "<<port<<": "<<ec.message()<<endl;
+			return false;
+		}
+
+		if(!output.begin(g_width, g_height))return false;
+
+		STATS_TIMER(PASS_FRAME);
+		TRACE_SCOPE("frame", "frame");
+
+		cout<<"waiting for workers on port "<<port<<", "<<tiles.size()<<" tiles to render"<<endl;
+
+		accept();
+		boost::thread acceptThread(boost::bind(&Coordinator::runAcceptor, this));
+
+		queue.wait();
+
+		// stop accepting, wait for all workers to be released
+		io.stop();
+		acceptThread.join();
+		workers.join_all();
+
+		return output.end();
+	}
+};
+
+bool RunCoordinator(const unsigned short port, ITileOutput& output)
+{
+	Coordinator coordinator(output);
+
+	return coordinator.run(port);
+}
+
+bool RunWorker(const std::string& endpoint)
+{
+	// split host:port
+	size_t pos = endpoint.rfind(':');
+	if(pos == string::npos)
+	{
+		cout<<"invalid coordinator address "<<endpoint<<endl;
+		return false;
+	}
+
+	string host = endpoint.substr(0, pos);
+	string port = endpoint.substr(pos + 1);
+
+	boost::asio::io_service io;
+	tcp::resolver resolver(io);
+	tcp::socket socket(io);
+	boost::system::error_code ec;
+
+	// coordinator might not be listening yet, retry for a while
+	for(int attempt = 0; attempt < 20; attempt++)
+	{
+		tcp::resolver::iterator it = resolver.resolve(tcp::resolver::query(host, port), ec);
+		if(!ec)boost::asio::connect(socket, it, ec);
+		if(!ec)break;
+
+		boost::this_thread::sleep(boost::posix_time::milliseconds(500));
+	}
+
+	if(ec)
+	{
+		cout<<"could not connect to "<<endpoint<<": "<<ec.message()<<endl;
+		return false;
+	}
+
+	// receive scene and settings
+	int header[5];
+	if(!receive(socket, header, 5) || header[0] != protocol_magic)
+	{
+		cout<<"invalid coordinator"<<endl;
+		return false;
+	}
+
+	string scene(header[3], ' ');
+	if(header[3] > 0 && !receive(socket, &scene[0], scene.size()))return false;
+
+	string settings(header[4], ' ');
+	if(header[4] > 0 && !receive(socket, &settings[0], settings.size()))return false;
+
+	if(!readSettings(settings))
+	{
+		cout<<"invalid settings from coordinator: "<<settings<<endl;
+		return false;
+	}
+
+	g_width = header[1];
+	g_height = header[2];
+
+	deleteScene();
+	istringstream in(scene);
+	if(!readScene(in, g_camera, g_objects, g_lights) || !buildAccelerators())return false;
+
+	// render tiles till coordinator is done
+	STATS_TIMER(PASS_FRAME);
+	TRACE_SCOPE("worker", "frame");
+
+	TileBuffers buffers;
+	int msg[4];
+	int count = 0;
+
+	while(receive(socket, msg, 4) && msg[2] > 0)
+	{
+		Tile tile(msg[0], msg[1], msg[2], msg[3]);
+
+		TraceTile(tile, buffers);
+
+		if(!send(socket, msg, 4) || !sendImage(socket, buffers.image, 3) || !sendImage(socket, buffers.aopass, 1))break;
+
+		count++;
+	}
+
+	cout<<"rendered "<<count<<" tiles"<<endl;
+
+	return true;
+}
\ No newline at end of file
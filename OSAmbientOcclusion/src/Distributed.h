@@ -0,0 +1,28 @@
+// Object Space Ambient Occlusion Demo Project
+// (c) 2013 by L.Spiegelberg
+// This code may be redistributed or modified for any learning or teaching purposes
+// but not for any commercial uses
+// to gain further license informations please contact me via
+// spiegelb (at) in.tum.de
+
+#ifndef DISTRIBUTED_HEADER_
+#define DISTRIBUTED_HEADER_
+
+#include <string>
+
+#include "TileOutput.h"
+
+// tiles can be rendered by several worker processes(on one or more machines):
+// the coordinator sends the scene and its render settings to every worker that connects, hands out
+// tiles one by one and composites the returned color and ambient occlusion tiles into output.
+// tiles of workers that disconnect or take too long are handed out again
+
+/// distribute the current scene to workers connecting to port, returns after all tiles are written,
+/// false if the output failed
+bool RunCoordinator(const unsigned short port, ITileOutput& output);
+
+/// connect to a coordinator at host:port and render tiles until it runs out of work,
+/// returns false if no connection could be established
+bool RunWorker(const std::string& endpoint);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,303 @@
+// Object Space Ambient Occlusion Demo Project
+// (c) 2013 by L.Spiegelberg
+// This code may be redistributed or modified for any learning or teaching purposes
+// but not for any commercial uses
+// to gain further license informations please contact me via
+// spiegelb (at) in.tum.de
+
+#ifndef GBUFFER_HEADER_
+#define GBUFFER_HEADER_
+
+#include <cassert>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "Vector.h"
+#include "Camera.h"
+#include "Tiles.h"
+#include "Stats.h"
+#include "Pool.h"
+
+// compact buffer of the camera ray hits, 12 bytes per pixel.
+// positions are stored as distance along the camera ray of the pixel and reconstructed with the
+// camera the buffer was filled with, normals as two 16 bit octahedral coordinates
+class GBuffer
+{
+private:
+	/// one pixel
+	struct Sample
+	{
+		/// distance along the camera ray
+		float			depth;
+
+		/// octahedral normal
+		unsigned short	u;
+		unsigned short	v;
+
+		/// index of the hit object in the scene list, no_object if nothing was hit
+		int				object;
+	};
+
+	Sample *samples;
+	int width, height;
+
+	/// camera the buffer is filled with, pixel(x, y) belongs to the camera ray through(x + offsetX, y + offsetY)
+	Camera	camera;
+	int		offsetX;
+	int		offsetY;
+
+	/// octahedral coordinate in [-1, 1] to 16 bit
+	static inline unsigned short quantize(const float f)
+	{
+		return (unsigned short)floor((std::min(std::max(f, -1.0f), 1.0f) * 0.5f + 0.5f) * 65535.0f + 0.5f);
+	}
+
+	static inline float dequantize(const unsigned short s)
+	{
+		return (float)s / 65535.0f * 2.0f - 1.0f;
+	}
+
+	static inline float signNotZero(const float f)	{return f < 0.0f ? -1.0f : 1.0f;}
+
+	static void encodeNormal(const Vector& n, unsigned short& u, unsigned short& v)
+	{
+		// project on the octahedron |x| + |y| + |z| = 1, the lower half is folded over the upper one
+		float l1 = std::abs(n.x) + std::abs(n.y) + std::abs(n.z);
+		float x = n.x / l1;
+		float y = n.y / l1;
+
+		if(n.z < 0.0f)
+		{
+			float fx = (1.0f - std::abs(y)) * signNotZero(x);
+			float fy = (1.0f - std::abs(x)) * signNotZero(y);
+			x = fx;
+			y = fy;
+		}
+
+		u = quantize(x);
+		v = quantize(y);
+	}
+
+	static Vector decodeNormal(const unsigned short u, const unsigned short v)
+	{
+		float x = dequantize(u);
+		float y = dequantize(v);
+		float z = 1.0f - std::abs(x) - std::abs(y);
+
+		if(z < 0.0f)
+		{
+			float fx = (1.0f - std::abs(y)) * signNotZero(x);
+			float fy = (1.0f - std::abs(x)) * signNotZero(y);
+			x = fx;
+			y = fy;
+		}
+
+		Vector n(x, y, z);
+		n.normalize();
+
+		return n;
+	}
+
+	/// give samples back to the pool
+	void release()
+	{
+		if(!samples)return;
+
+		STATS_MEMORY(-bytes());
+		ArrayPool<Sample>::instance().release(samples, width * height);
+		samples = NULL;
+	}
+
+	/// (re)allocate samples, the buffer is kept if the size stays the same. contents are undefined afterwards
+	void allocate(const int _width, const int _height)
+	{
+		if(samples && width == _width && height == _height)return;
+
+		release();
+
+		width = _width;
+		height = _height;
+
+		samples = ArrayPool<Sample>::instance().acquire(width * height);
+		STATS_MEMORY(bytes());
+	}
+
+public:
+	/// object index of pixels without hit
+	static const int no_object = -1;
+
+	GBuffer():samples(NULL), width(0), height(0), offsetX(0), offsetY(0)	{}
+
+	GBuffer(const int _width, const int _height):samples(NULL), width(0), height(0), offsetX(0), offsetY(0)
+	{
+		create(_width, _height);
+	}
+
+	GBuffer(const GBuffer& buf):samples(NULL), width(0), height(0), offsetX(0), offsetY(0)
+	{
+		*this = buf;
+	}
+
+	/// take over the samples of buf, which is left empty
+	GBuffer(GBuffer&& buf):samples(NULL), width(0), height(0), offsetX(0), offsetY(0)
+	{
+		swap(buf);
+	}
+
+	GBuffer& operator = (GBuffer&& buf)
+	{
+		swap(buf);
+		return *this;
+	}
+
+	~GBuffer()
+	{
+		release();
+	}
+
+	/// exchange contents with another buffer without copying
+	void swap(GBuffer& buf)
+	{
+		std::swap(samples, buf.samples);
+		std::swap(width, buf.width);
+		std::swap(height, buf.height);
+		std::swap(camera, buf.camera);
+		std::swap(offsetX, buf.offsetX);
+		std::swap(offsetY, buf.offsetY);
+	}
+
+	/// create buffer manually, nothing is hit
+	void create(const int _width, const int _height)
+	{
+		allocate(_width, _height);
+
+		for(int i = 0; i < width * height; i++)
+		{
+			samples[i].depth = 0.0f;
+			samples[i].u = samples[i].v = 0;
+			samples[i].object = no_object;
+		}
+	}
+
+	/// (re)allocate without clearing, samples are undefined until written(see Image::resize)
+	inline void resize(const int _width, const int _height)
+	{
+		allocate(_width, _height);
+	}
+
+	/// nothing is hit in a tile
+	void clear(const Tile& tile)
+	{
+		assert(tile.x >= 0 && tile.y >= 0 && tile.x + tile.width <= width && tile.y + tile.height <= height);
+
+		for(int y = tile.y; y < tile.y + tile.height; y++)
+			for(int x = tile.x; x < tile.x + tile.width; x++)
+			{
+				Sample& s = samples[x + y * width];
+				s.depth = 0.0f;
+				s.u = s.v = 0;
+				s.object = no_object;
+			}
+	}
+
+	/// camera rays the following samples belong to, the buffer holds the pixels from(x, y) on
+	void setCamera(const Camera& cam, const int x, const int y)
+	{
+		camera = cam;
+		offsetX = x;
+		offsetY = y;
+	}
+
+	inline int getWidth() const {return width;}
+	inline int getHeight() const {return height;}
+
+	/// size of buffer data in bytes
+	inline long long bytes() const {return (long long)sizeof(Sample) * width * height;}
+
+	GBuffer& operator =		(const GBuffer& buf)
+	{
+		if(this == &buf)return *this;
+
+		// keeps buffers if the size stays the same
+		allocate(buf.width, buf.height);
+
+		for(int i = 0; i < width*height; i++)samples[i] = buf.samples[i];
+
+		camera = buf.camera;
+		offsetX = buf.offsetX;
+		offsetY = buf.offsetY;
+
+		return *this;
+	}
+
+	/// store hit of the camera ray of pixel(x, y), normal is ignored if nothing was hit
+	void setSample(const int x, const int y, const float depth, const Vector& normal, const int object)
+	{
+		assert(0 <= x + y * width && x + y *width < width * height);
+
+		Sample& s = samples[x + y * width];
+		s.depth = depth;
+		s.object = object;
+
+		if(object == no_object)s.u = s.v = 0;
+		else encodeNormal(normal, s.u, s.v);
+	}
+
+	/// hit point, the camera ray is evaluated like in traceRay so it is the same point
+	Vector getPoint(const int x, const int y)
+	{
+		assert(0 <= x + y * width && x + y *width < width * height);
+
+		Ray r = camera.getRay((float)(x + offsetX), (float)(y + offsetY));
+
+		return r.origin + samples[x + y * width].depth * r.direction;
+	}
+
+	/// normal of the hit, zero if nothing was hit
+	Vector getNormal(const int x, const int y)
+	{
+		assert(0 <= x + y * width && x + y *width < width * height);
+
+		const Sample& s = samples[x + y * width];
+		if(s.object == no_object)return Vector(0.0f, 0.0f, 0.0f);
+
+		return decodeNormal(s.u, s.v);
+	}
+
+	/// object was deleted from the scene list, hits of the objects behind it move down by one index.
+	/// pixels which hit the deleted object keep its index until they are traced again
+	void removeObject(const int object)
+	{
+		for(int i = 0; i < width * height; i++)
+			if(samples[i].object > object)samples[i].object--;
+	}
+
+	inline float getDepth(const int x, const int y) const	{return samples[x + y * width].depth;}
+	inline int getObject(const int x, const int y) const	{return samples[x + y * width].object;}
+
+	/// points and normals of a rectangle of the buffer, stored row by row
+	void getTile(const Tile& tile, std::vector<Vector>& points, std::vector<Vector>& normals)
+	{
+		assert(tile.x >= 0 && tile.y >= 0 && tile.x + tile.width <= width && tile.y + tile.height <= height);
+
+		points.resize(tile.width * tile.height);
+		normals.resize(tile.width * tile.height);
+
+		for(int y = 0; y < tile.height; y++)
+		{
+			const Sample *row = samples + tile.x + (tile.y + y) * width;
+
+			for(int x = 0; x < tile.width; x++)
+			{
+				int index = x + y * tile.width;
+
+				Ray r = camera.getRay((float)(tile.x + x + offsetX), (float)(tile.y + y + offsetY));
+				points[index] = r.origin + row[x].depth * r.direction;
+				normals[index] = row[x].object == no_object ? Vector(0.0f, 0.0f, 0.0f) : decodeNormal(row[x].u, row[x].v);
+			}
+		}
+	}
+};
+
+#endif
\ No newline at end of file
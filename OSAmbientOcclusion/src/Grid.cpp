@@ -0,0 +1,291 @@
+// Object Space Ambient Occlusion Demo Project
+// (c) 2013 by L.Spiegelberg
+// This code may be redistributed or modified for any learning or teaching purposes
+// but not for any commercial uses
+// to gain further license informations please contact me via
+// spiegelb (at) in.tum.de
+
+#include <algorithm>
+#include <cmath>
+
+#include "Grid.h"
+
+using namespace std;
+
+const int UniformGrid::max_resolution;
+
+static inline float component(const Vector& v, const int axis)
+{
+	return axis == 0 ? v.x : (axis == 1 ? v.y : v.z);
+}
+
+UniformGrid::UniformGrid(const vector<IObject*>& _objects, const float _cellSize):objects(_objects),
+	cellSize(_cellSize), tableMask(0), cellCount(0)
+{
+	res[0] = res[1] = res[2] = 1;
+
+	if(objects.empty())return;
+
+	// bounds of the scene, slightly enlarged so surfaces on the border lie inside
+	objects[0]->getBounds(bmin, bmax);
+	for(unsigned int i = 1; i < objects.size(); i++)
+	{
+		Vector omin, omax;
+		objects[i]->getBounds(omin, omax);
+
+		bmin = VectorMin(bmin, omin);
+		bmax = VectorMax(bmax, omax);
+	}
+
+	const Vector border(0.001f, 0.001f, 0.001f);
+	bmin -= border;
+	bmax += border;
+
+	// resolution, cells are cubes
+	Vector extent = bmax - bmin;
+	float maxExtent = max(extent.x, max(extent.y, extent.z));
+
+	if(cellSize <= 0.0f || maxExtent / cellSize > (float)max_resolution)cellSize = maxExtent / (float)max_resolution;
+	invCellSize = 1.0f / cellSize;
+
+	for(int a = 0; a < 3; a++)
+		res[a] = max(1, min(max_resolution, (int)ceil(component(extent, a) * invCellSize)));
+
+	// sort objects into all cells their surface overlaps
+	vector<pair<unsigned long long, int> > entries;
+
+	for(unsigned int i = 0; i < objects.size(); i++)
+	{
+		Vector omin, omax;
+		objects[i]->getBounds(omin, omax);
+
+		int cmin[3], cmax[3];
+		for(int a = 0; a < 3; a++)
+		{
+			cmin[a] = max(0, min(res[a] - 1, (int)floor((component(omin, a) - component(bmin, a)) * invCellSize)));
+			cmax[a] = max(0, min(res[a] - 1, (int)floor((component(omax, a) - component(bmin, a)) * invCellSize)));
+		}
+
+		for(int z = cmin[2]; z <= cmax[2]; z++)
+			for(int y = cmin[1]; y <= cmax[1]; y++)
+				for(int x = cmin[0]; x <= cmax[0]; x++)
+				{
+					Vector vmin = bmin + Vector((float)x, (float)y, (float)z) * cellSize;
+					Vector vmax = vmin + Vector(cellSize, cellSize, cellSize);
+
+					if(objects[i]->overlaps(vmin, vmax))entries.push_back(make_pair(makeKey(x, y, z), (int)i));
+				}
+	}
+
+	sort(entries.begin(), entries.end());
+
+	for(unsigned int i = 0; i < entries.size(); i++)
+		if(i == 0 || entries[i].first != entries[i - 1].first)cellCount++;
+
+	// hash table at most half full
+	unsigned int size = 1;
+	while(size < 2 * (unsigned int)cellCount)size <<= 1;
+
+	Cell empty;
+	empty.key = empty_key;
+	empty.start = empty.count = 0;
+
+	table.assign(size, empty);
+	tableMask = size - 1;
+
+	indices.resize(entries.size());
+
+	unsigned int start = 0;
+	while(start < entries.size())
+	{
+		unsigned int end = start;
+		while(end < entries.size() && entries[end].first == entries[start].first)
+		{
+			indices[end] = entries[end].second;
+			end++;
+		}
+
+		unsigned int slot = hash(entries[start].first) & tableMask;
+		while(table[slot].key != empty_key)slot = (slot + 1) & tableMask;
+
+		table[slot].key = entries[start].first;
+		table[slot].start = (int)start;
+		table[slot].count = (int)(end - start);
+
+		start = end;
+	}
+}
+
+bool UniformGrid::traverse(const Ray& r, float tmin, float tmax, const bool anyHit, float& fDistance, Vector& normal, Color& color, IObject **object)
+{
+	if(indices.empty())return false;
+
+	// range hits are accepted in
+	const float rayMin = tmin;
+	const float rayMax = tmax;
+
+	// clip ray against grid bounds
+	for(int a = 0; a < 3; a++)
+	{
+		float o = component(r.origin, a);
+		float d = component(r.direction, a);
+
+		if(d == 0.0f)
+		{
+			if(o < component(bmin, a) || o > component(bmax, a))return false;
+		}
+		else
+		{
+			float t0 = (component(bmin, a) - o) / d;
+			float t1 = (component(bmax, a) - o) / d;
+			if(t0 > t1)swap(t0, t1);
+
+			tmin = max(tmin, t0);
+			tmax = min(tmax, t1);
+		}
+	}
+
+	if(tmin > tmax)return false;
+
+	// setup cell walk(Amanatides & Woo)
+	int cell[3], step[3];
+	float tNext[3], tDelta[3];
+
+	for(int a = 0; a < 3; a++)
+	{
+		float o = component(r.origin, a);
+		float d = component(r.direction, a);
+		float lo = component(bmin, a);
+
+		cell[a] = max(0, min(res[a] - 1, (int)floor((o + d * tmin - lo) * invCellSize)));
+
+		if(d > 0.0f)
+		{
+			step[a] = 1;
+			tNext[a] = (lo + (float)(cell[a] + 1) * cellSize - o) / d;
+			tDelta[a] = cellSize / d;
+		}
+		else if(d < 0.0f)
+		{
+			step[a] = -1;
+			tNext[a] = (lo + (float)cell[a] * cellSize - o) / d;
+			tDelta[a] = -cellSize / d;
+		}
+		else
+		{
+			step[a] = 0;
+			tNext[a] = tDelta[a] = 1e30f;
+		}
+	}
+
+	int mailbox[mailbox_size];
+	for(int i = 0; i < mailbox_size; i++)mailbox[i] = -1;
+	int mailboxNext = 0;
+
+	bool intersection = false;
+	float best = rayMax;
+
+	while(true)
+	{
+		float tExit = min(tNext[0], min(tNext[1], tNext[2]));
+
+		const Cell *c = findCell(makeKey(cell[0], cell[1], cell[2]));
+
+		if(c)
+		{
+			for(int i = c->start; i < c->start + c->count; i++)
+			{
+				int index = indices[i];
+
+				// tested in a previous cell?
+				bool tested = false;
+				for(int k = 0; k < mailbox_size; k++)
+					if(mailbox[k] == index)tested = true;
+				if(tested)continue;
+
+				mailbox[mailboxNext] = index;
+				mailboxNext = (mailboxNext + 1) % mailbox_size;
+
+				STATS_ADD(intersectionTests, 1);
+
+				float dist;
+				Vector n;
+				Color col;
+				if(!objects[index]->intersect(r, dist, n, col))continue;
+
+				if(anyHit)
+				{
+					if(dist > rayMin && dist < rayMax)
+					{
+						STATS_ADD(hits, 1);
+						return true;
+					}
+				}
+				else if(dist >= rayMin && dist < best)
+				{
+					intersection = true;
+					best = dist;
+					normal = n;
+					color = col;
+
+					if(object)*object = objects[index];
+				}
+			}
+		}
+
+		// nearest hit lies in a cell already visited, no later object can be nearer
+		if(intersection && best <= tExit)break;
+
+		if(tExit >= tmax)break;
+
+		// step to next cell
+		int a = tNext[0] < tNext[1] ? (tNext[0] < tNext[2] ? 0 : 2) : (tNext[1] < tNext[2] ? 1 : 2);
+
+		cell[a] += step[a];
+		if(cell[a] < 0 || cell[a] >= res[a])break;
+
+		tNext[a] += tDelta[a];
+	}
+
+	if(intersection)
+	{
+		fDistance = best;
+		STATS_ADD(hits, 1);
+	}
+
+	return intersection;
+}
+
+bool UniformGrid::intersect(const Ray& r, float& fDistance, Vector& normal, Color& color)
+{
+	fDistance = no_hit_distance;
+	color = Color::white;
+
+	return traverse(r, 0.0f, no_hit_distance, false, fDistance, normal, color);
+}
+
+bool UniformGrid::intersectObject(const Ray& r, float& fDistance, Vector& normal, Color& color, IObject *&object)
+{
+	fDistance = no_hit_distance;
+	color = Color::white;
+	object = NULL;
+
+	return traverse(r, 0.0f, no_hit_distance, false, fDistance, normal, color, &object);
+}
+
+bool UniformGrid::occluded(const Ray& r, const float tmin, const float tmax)
+{
+	float fDistance;
+	Vector normal;
+	Color color;
+
+	return traverse(r, tmin, tmax, true, fDistance, normal, color);
+}
+
+bool UniformGrid::hitDistance(const Ray& r, const float tmin, const float tmax, float& fDistance)
+{
+	Vector normal;
+	Color color;
+
+	return traverse(r, tmin, tmax, false, fDistance, normal, color);
+}
\ No newline at end of file
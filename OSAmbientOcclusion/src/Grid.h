@@ -0,0 +1,94 @@
+// Object Space Ambient Occlusion Demo Project
+// (c) 2013 by L.Spiegelberg
+// This code may be redistributed or modified for any learning or teaching purposes
+// but not for any commercial uses
+// to gain further license informations please contact me via
+// spiegelb (at) in.tum.de
+
+#ifndef GRID_HEADER_
+#define GRID_HEADER_
+
+#include <vector>
+
+#include "Accelerator.h"
+
+/// uniform grid stored as spatial hash, only cells containing surfaces use memory.
+/// made for short rays like the ambient occlusion kernel: a ray only walks the few
+/// cells between tmin and tmax, so the cell size should be about the ray length
+class UniformGrid : public IAccelerator
+{
+private:
+	/// entry of the hash table, key is empty_key for free slots
+	struct Cell
+	{
+		unsigned long long	key;
+		int					start;	// first object in indices
+		int					count;
+	};
+
+	static const unsigned long long empty_key = ~0ULL;
+
+	/// cells per axis are limited so keys fit into 21 bits per axis
+	static const int max_resolution = 1024;
+
+	/// objects tested per ray are remembered so objects spanning several cells are tested once
+	static const int mailbox_size = 8;
+
+	std::vector<IObject*>	objects;
+
+	/// bounds of the grid
+	Vector	bmin;
+	Vector	bmax;
+
+	float	cellSize;
+	float	invCellSize;
+	int		res[3];
+
+	std::vector<Cell>	table;
+	unsigned int		tableMask;
+	int					cellCount;
+
+	/// object indices of all cells, cell after cell
+	std::vector<int>	indices;
+
+	static inline unsigned long long makeKey(const int x, const int y, const int z)
+	{
+		return (unsigned long long)x | ((unsigned long long)y << 21) | ((unsigned long long)z << 42);
+	}
+
+	static inline unsigned int hash(const unsigned long long key)
+	{
+		return (unsigned int)((key * 0x9E3779B97F4A7C15ULL) >> 32);
+	}
+
+	/// cell of key, NULL if empty
+	inline const Cell *findCell(const unsigned long long key) const
+	{
+		for(unsigned int i = hash(key) & tableMask; ; i = (i + 1) & tableMask)
+		{
+			const Cell& c = table[i];
+
+			if(c.key == key)return &c;
+			if(c.key == empty_key)return NULL;
+		}
+	}
+
+	/// walk cells along the ray from tmin to tmax, anyHit stops at the first hit in (tmin, tmax)
+	bool traverse(const Ray& r, float tmin, float tmax, const bool anyHit, float& fDistance, Vector& normal, Color& color, IObject **object = NULL);
+
+public:
+	UniformGrid(const std::vector<IObject*>& _objects, const float _cellSize);
+
+	virtual bool intersect(const Ray& r, float& fDistance, Vector& normal, Color& color);
+
+	virtual bool intersectObject(const Ray& r, float& fDistance, Vector& normal, Color& color, IObject *&object);
+
+	virtual bool occluded(const Ray& r, const float tmin, const float tmax);
+
+	virtual bool hitDistance(const Ray& r, const float tmin, const float tmax, float& fDistance);
+
+	/// number of non empty cells
+	inline int getCellCount() const	{return cellCount;}
+};
+
+#endif
\ No newline at end of file
@@ -9,25 +9,66 @@
 #ifndef IMAGE_HEADER_
 #define IMAGE_HEADER_
 
+#include <algorithm>
+
 #include "Color.h"
+#include "Tiles.h"
+#include "Stats.h"
+#include "Trace.h"
+#include "Pool.h"
 
 class Image
 {
 private:
-	/// a color map to hold the image data
+	/// a color map to hold the image data, taken from the pool
 	Color *data; 
 
 	/// width/height of image
 	int		width;
 	int		height;
 
-	/// OpenGL Texture ID
+	/// OpenGL Texture ID, 0 if not created yet
 	GLuint	id;
 
 	/// does texture need to be updated?
 	bool	modified;
 
-	/// internal update function
+	/// data was taken from the pool, false for memory given to attach
+	bool	owned;
+
+	// no copies, use copyFrom or swap
+	Image(const Image&);
+	Image& operator = (const Image&);
+
+	/// give data back to the pool
+	void	release()
+	{
+		if(!data)return;
+
+		if(owned)
+		{
+			STATS_MEMORY(-bytes());
+			ArrayPool<Color>::instance().release(data, width * height);
+		}
+		data = NULL;
+	}
+
+	/// (re)allocate data if the size changed, contents are undefined afterwards
+	void	allocate(const int _width, const int _height)
+	{
+		if(data && width == _width && height == _height)return;
+
+		release();
+
+		width	= _width;
+		height	= _height;
+
+		data	= ArrayPool<Color>::instance().acquire(width * height);
+		owned	= true;
+		STATS_MEMORY(bytes());
+	}
+
+	/// internal update function, only called from the thread owning the OpenGL context
 	void	update()
 	{
 		// select texture
@@ -36,7 +77,7 @@ private:
 
 
 		// use for the texture 32 Bit format
-		unsigned long *buffer = new unsigned long[width * height];
+		unsigned long *buffer = ArrayPool<unsigned long>::instance().acquire(width * height);
 
 		// set buffer to internal pointer
 		for(int i = 0; i < width * height; i++)
@@ -54,43 +95,213 @@ private:
 		glTexImage2D(GL_TEXTURE_2D, 0, 4, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, buffer); 
 		glDisable(GL_TEXTURE_2D);
 
-		delete [] buffer;
+		ArrayPool<unsigned long>::instance().release(buffer, width * height);
+	}
+
+	/// apply box filter of size blurSize() to a region of src(with periodic boundaries) and write it to dst
+	static void blurDataGeneric(const Color *src, const int srcwidth, const int srcheight, const int srcx, const int srcy,
+		Color *dst, const int dstwidth, const int dstx, const int dsty, const int w, const int h)
+	{
+		// construct a kernel
+		int kernel_sizex = blurSize();
+		int kernel_sizey = blurSize();
+
+		// kernel size has to be odd
+		assert(kernel_sizex & 0x1);
+		assert(kernel_sizey & 0x1);
+
+		// box filter, all weights are the same
+		const float weight = 1.0f / (float)(kernel_sizex * kernel_sizey);
+
+		// go through region and apply kernel
+		for(int x = 0;  x < w; x++)
+			for(int y = 0; y < h; y++)
+			{
+				// zero color
+				Color sum = Color(0.0f, 0.0f, 0.0f);
+
+				// apply kernel (with periodic boundaries)
+				for(int i = 0; i < kernel_sizex; i++)
+					for(int j = 0; j < kernel_sizey; j++)
+					{
+						int xindex = srcx + x + i - kernel_sizex / 2;
+						int yindex = srcy + y + j - kernel_sizey / 2;
+
+						// apply periodic conditions
+						if(xindex >= srcwidth)xindex -= srcwidth;
+						if(yindex >= srcheight)yindex -= srcheight;
+						if(xindex < 0)xindex += srcwidth;
+						if(yindex < 0)yindex += srcheight;
+
+
+						assert(xindex >= 0 && xindex < srcwidth);
+						assert(yindex >= 0 && yindex < srcheight);
+						
+						// add kernel
+						sum = sum   +   weight * src[xindex + yindex * srcwidth];
+					}
+
+				dst[dstx + x + (dsty + y) * dstwidth] = sum;
+			}
+	}
+
+	/// box filter with a kernel size known at compile time. rows are filtered one after another, only pixels
+	/// whose kernel crosses the image border wrap around. taps are summed in the order of blurDataGeneric,
+	/// so the result is the same
+	template<int SIZE> static void blurDataFixed(const Color *src, const int srcwidth, const int srcheight, const int srcx, const int srcy,
+		Color *dst, const int dstwidth, const int dstx, const int dsty, const int w, const int h)
+	{
+		const int r = SIZE / 2;
+		const float weight = 1.0f / (float)(SIZE * SIZE);
+
+		for(int y = 0; y < h; y++)
+		{
+			// source rows of the kernel
+			const Color *rows[SIZE];
+			for(int j = 0; j < SIZE; j++)
+			{
+				int yindex = srcy + y + j - r;
+				if(yindex >= srcheight)yindex -= srcheight;
+				if(yindex < 0)yindex += srcheight;
+
+				assert(yindex >= 0 && yindex < srcheight);
+
+				rows[j] = src + yindex * srcwidth;
+			}
+
+			Color *out = dst + dstx + (dsty + y) * dstwidth;
+
+			for(int x = 0; x < w; x++)
+			{
+				int first = srcx + x - r;
+
+				// source columns of the kernel
+				int columns[SIZE];
+				if(first >= 0 && first + SIZE <= srcwidth)
+				{
+					for(int i = 0; i < SIZE; i++)columns[i] = first + i;
+				}
+				else
+				{
+					for(int i = 0; i < SIZE; i++)
+					{
+						int xindex = first + i;
+						if(xindex >= srcwidth)xindex -= srcwidth;
+						if(xindex < 0)xindex += srcwidth;
+
+						assert(xindex >= 0 && xindex < srcwidth);
+
+						columns[i] = xindex;
+					}
+				}
+
+				Color sum = Color(0.0f, 0.0f, 0.0f);
+
+				for(int i = 0; i < SIZE; i++)
+					for(int j = 0; j < SIZE; j++)sum = sum   +   weight * rows[j][columns[i]];
+
+				out[x] = sum;
+			}
+		}
+	}
+
+	/// common kernel sizes use a specialized filter
+	static void blurData(const Color *src, const int srcwidth, const int srcheight, const int srcx, const int srcy,
+		Color *dst, const int dstwidth, const int dstx, const int dsty, const int w, const int h)
+	{
+		switch(blurSize())
+		{
+		case 3:	blurDataFixed<3>(src, srcwidth, srcheight, srcx, srcy, dst, dstwidth, dstx, dsty, w, h); break;
+		case 5:	blurDataFixed<5>(src, srcwidth, srcheight, srcx, srcy, dst, dstwidth, dstx, dsty, w, h); break;
+		case 7:	blurDataFixed<7>(src, srcwidth, srcheight, srcx, srcy, dst, dstwidth, dstx, dsty, w, h); break;
+		case 9:	blurDataFixed<9>(src, srcwidth, srcheight, srcx, srcy, dst, dstwidth, dstx, dsty, w, h); break;
+		case 11:	blurDataFixed<11>(src, srcwidth, srcheight, srcx, srcy, dst, dstwidth, dstx, dsty, w, h); break;
+		default:	blurDataGeneric(src, srcwidth, srcheight, srcx, srcy, dst, dstwidth, dstx, dsty, w, h);
+		}
 	}
 
 public:
 
-	Image():data(NULL), width(0), height(0), id(-1), modified(false)		{}
+	Image():data(NULL), width(0), height(0), id(0), modified(false), owned(true)		{}
 
-	Image(const int _width, const int _height)
+	Image(const int _width, const int _height):data(NULL), width(0), height(0), id(0), modified(false), owned(true)
 	{
-		modified = false;
-		id		= -1;
-		width	= _width;
-		height	= _height;
-		data	= new Color[width * height];
+		create(_width, _height);
+	}
+
+	/// take over data and texture of img, which is left empty
+	Image(Image&& img):data(NULL), width(0), height(0), id(0), modified(false), owned(true)
+	{
+		swap(img);
+	}
+
+	Image& operator = (Image&& img)
+	{
+		swap(img);
+		return *this;
 	}
 
 	~Image()
 	{
 		// delete GL textures
-		if(id >= 0)glDeleteTextures(1, &id);
+		if(id)glDeleteTextures(1, &id);
 
-		if(data)delete [] data;
-		data = NULL;
+		release();
 	}
 
+	/// exchange contents with another image without copying
+	void swap(Image& img)
+	{
+		std::swap(data, img.data);
+		std::swap(width, img.width);
+		std::swap(height, img.height);
+		std::swap(id, img.id);
+		std::swap(modified, img.modified);
+		std::swap(owned, img.owned);
+	}
 
-	/// create image manually
-	inline void create(const int _width, const int _height)
+	/// use external memory of width * height colors(e.g. a memory mapped file) as image data, the contents are kept.
+	/// the memory is never freed by the image and has to outlive it
+	void attach(Color *external, const int _width, const int _height)
 	{
-		modified = true;
+		release();
+
+		data	= external;
 		width	= _width;
 		height	= _height;
+		owned	= false;
+
+		modified = true;
+	}
+
+	/// create image manually, all pixels are black. the buffer is kept if the size stays the same
+	inline void create(const int _width, const int _height)
+	{
+		modified = true;
+
+		allocate(_width, _height);
+
+		std::fill(data, data + width * height, Color());
+	}
+
+	/// (re)allocate without clearing, pixels are undefined until written. with --numa the tiles are
+	/// cleared by the threads rendering them, so the pages are placed on their nodes
+	inline void resize(const int _width, const int _height)
+	{
+		modified = true;
+
+		allocate(_width, _height);
+	}
+
+	/// set all pixels of a tile to black
+	void	clear(const Tile& tile)
+	{
+		assert(tile.x >= 0 && tile.x + tile.width <= width);
+		assert(tile.y >= 0 && tile.y + tile.height <= height);
 
-		// remove data
-		if(data)delete [] data;
+		for(int y = tile.y; y < tile.y + tile.height; y++)std::fill(data + tile.x + y * width, data + tile.x + tile.width + y * width, Color());
 
-		data	= new Color[width * height];
+		modified = true;
 	}
 
 	/// set pixel
@@ -118,7 +329,7 @@ public:
 	GLuint getTexture() 
 	{
 		// initialized?
-		if(id < 0)
+		if(!id)
 		{
 			// generate new texture
 			glGenTextures(1, &id);
@@ -126,7 +337,11 @@ public:
 		}
 
 		// perform update if necessary
-		if(modified)update();
+		if(modified)
+		{
+			TRACE_SCOPE("texture update", "display");
+			update();
+		}
 		modified = false;
 
 		return id;
@@ -139,84 +354,56 @@ public:
 	inline int getWidth() const {return width;}
 	inline int getHeight() const {return height;}
 
+	/// size of image data in bytes
+	inline long long bytes() const {return (long long)sizeof(Color) * width * height;}
+
+	/// size of the blur kernel(has to be odd), set once from the options before rendering
+	static int& blurSize()
+	{
+		static int size = 9;
+		return size;
+	}
+
 	/// blur image
 	void	blur()
 	{
-		// construct a kernel
-		int kernel_sizex = 9;
-		int kernel_sizey = 9;
-
-		// kernel size has to be odd
-		assert(kernel_sizex & 0x1);
-		assert(kernel_sizey & 0x1);
-
-		float	*kernel = new float[kernel_sizex * kernel_sizey];
-
-		for(int i = 0; i < kernel_sizex; i++)
-			for(int j = 0; j < kernel_sizey; j++)
-			{
-				kernel[i + j * kernel_sizey] = 1.0f / (float)(kernel_sizex * kernel_sizey);
-			}
-
-		// go through image and apply kernel
-		
 		// temp array
-		Color *temp = new Color[width * height];
-		
-		// zero colors
-		for(int i = 0;  i < width * height; i++)temp[i] = Color(0.0f, 0.0f, 0.0f); 
+		Color *temp = ArrayPool<Color>::instance().acquire(width * height);
+		STATS_MEMORY(bytes());
 
-		for(int x = 0;  x < width; x++)
-			for(int y = 0; y < height; y++)
-			{
-				// apply kernel (with periodic boundaries)
-				for(int i = 0; i < kernel_sizex; i++)
-					for(int j = 0; j < kernel_sizey; j++)
-					{
-						int xindex = x + i - kernel_sizex / 2;
-						int yindex = y + j - kernel_sizey / 2;
-
-						// apply periodic conditions
-						if(xindex >= width)xindex -= width;
-						if(yindex >= height)yindex -= height;
-						if(xindex < 0)xindex += width;
-						if(yindex < 0)yindex += height;
+		blurData(data, width, height, 0, 0, temp, width, 0, 0, width, height);
 
+		// set pointers, attached memory has to stay in place
+		if(owned)std::swap(data, temp);
+		else std::copy(temp, temp + width * height, data);
+		ArrayPool<Color>::instance().release(temp, width * height);
+		STATS_MEMORY(-bytes());
 
-						assert(xindex >= 0 && xindex < width);
-						assert(yindex >= 0 && yindex < height);
-						
-						// add kernel
-						temp[x + y * width] = temp[x + y * width]   +   kernel[i + j * kernel_sizex] * data[xindex + yindex * width];
-					}
-			}
-
-
-		// set pointers
-		Color *delpointer = data;
-		data = temp;
-		delete [] delpointer;
+		modified = true;
+	}
 
+	/// blur a region(w x h) of another image starting at (srcx, srcy) and store it at (dstx, dsty),
+	/// if src holds a border of blurSize() / 2 pixels around the region no periodic boundaries are used
+	void	blurFrom(const Image& src, const int srcx, const int srcy,
+		const int dstx, const int dsty, const int w, const int h)
+	{
+		assert(dstx >= 0 && dstx + w <= width);
+		assert(dsty >= 0 && dsty + h <= height);
 
-		delete [] kernel;
+		modified = true;
 
-		update();
+		blurData(src.data, src.width, src.height, srcx, srcy, data, width, dstx, dsty, w, h);
 	}
 
-	/// copy image from another
+	/// copy image from another, the buffer is kept if the size stays the same
 	void	copyFrom(const Image& img)
 	{
-		// delete data
-		if(data)delete [] data;
-		width = img.width;
-		height = img.height;
-
-		data = new Color[width * height];
+		allocate(img.width, img.height);
 
 		// copy
 		for(int i = 0; i < width * height; i++)data[i] = img.data[i];
 
-		update();
+		modified = true;
 	}
 
 	/// inverse
@@ -224,7 +411,7 @@ public:
 	{
 		for(int i = 0; i < width * height; i++)data[i] = Color(1.0f, 1.0f, 1.0f) - data[i];
 
-		update();
+		modified = true;
 	}
 
 	/// multiply with image
@@ -236,7 +423,7 @@ public:
 
 		for(int i = 0; i < width * height; i++)data[i] = data[i] * img.data[i];
 
-		update();
+		modified = true;
 	}
 
 	/// normalize image(stretch values to 0.0 - 1.0)
@@ -266,7 +453,7 @@ public:
 			data[i] = data[i] * cscale - cmin;
 		}
 
-		update();
+		modified = true;
 	}
 };
 
@@ -0,0 +1,136 @@
+// Object Space Ambient Occlusion Demo Project
+// (c) 2013 by L.Spiegelberg
+// This code may be redistributed or modified for any learning or teaching purposes
+// but not for any commercial uses
+// to gain further license informations please contact me via
+// spiegelb (at) in.tum.de
+
+#ifndef INSTANCE_HEADER_
+#define INSTANCE_HEADER_
+
+#include <vector>
+#include <string>
+#include <boost/shared_ptr.hpp>
+
+#include "Objects.h"
+#include "Matrix.h"
+#include "BVH.h"
+
+/// objects in a local coordinate system, shared by all instances placing them in the scene.
+/// owns the objects and a bottom level BVH over them
+class Geometry
+{
+private:
+	std::string				name;
+	std::vector<IObject*>	objects;
+	BVH						bvh;
+
+	// no copies, objects are owned
+	Geometry(const Geometry&);
+	Geometry& operator = (const Geometry&);
+
+public:
+	Geometry(const std::string& _name, const std::vector<IObject*>& _objects):name(_name), objects(_objects), bvh(_objects)	{}
+
+	~Geometry()
+	{
+		for(std::vector<IObject*>::iterator it = objects.begin(); it != objects.end(); ++it)delete *it;
+	}
+
+	inline const std::string& getName() const	{return name;}
+
+	inline BVH& getBVH()	{return bvh;}
+
+	inline const std::vector<IObject*>& getObjects() const	{return objects;}
+
+	/// write as geometry block(see SceneIO.h)
+	void write(std::ostream& out)
+	{
+		out<<"geometry "<<name<<" "<<objects.size()<<std::endl;
+
+		for(std::vector<IObject*>::iterator it = objects.begin(); it != objects.end(); ++it)
+		{
+			out<<"  ";
+			(*it)->write(out);
+		}
+	}
+};
+
+/// places a shared geometry in the scene with an affine transformation
+/// world = transform * local + translation, only the transformation is stored per instance
+class Instance : public IObject
+{
+private:
+	boost::shared_ptr<Geometry>	geometry;
+
+	Matrix3x3	transform;
+	Vector		translation;
+
+	// world to local and its transposed for the normals
+	Matrix3x3	inverse;
+	Matrix3x3	normalMatrix;
+
+public:
+	Instance(const boost::shared_ptr<Geometry>& _geometry, const Matrix3x3& _transform, const Vector& _translation):
+		geometry(_geometry), transform(_transform), translation(_translation)
+	{
+		inverse = transform.getInverse();
+		normalMatrix = inverse.getTransposed();
+	}
+
+	virtual bool intersect(const Ray& r, float& fDistance, Vector& normal, Color& color)
+	{
+		// ray in local space, the direction is normalized again so the objects
+		// see a regular ray, distances are scaled back afterwards
+		Vector dir = inverse * r.direction;
+		float scale = VectorLength(dir);
+
+		Ray local;
+		local.origin = inverse * (r.origin - translation);
+		local.direction = dir / scale;
+
+		float localDistance;
+		Vector localNormal;
+		if(!geometry->getBVH().intersect(local, localDistance, localNormal, color))return false;
+
+		fDistance = localDistance / scale;
+		normal = normalMatrix * localNormal;
+		normal.normalize();
+
+		return true;
+	}
+
+	virtual void write(std::ostream& out)
+	{
+		out<<"instance "<<geometry->getName()<<" "<<transform<<" "<<translation<<std::endl;
+	}
+
+	virtual void getBounds(Vector& vmin, Vector& vmax)
+	{
+		// transform all corners of the local bounds
+		Vector lmin, lmax;
+		geometry->getBVH().getBounds(lmin, lmax);
+
+		for(int i = 0; i < 8; i++)
+		{
+			Vector corner((i & 1) ? lmax.x : lmin.x, (i & 2) ? lmax.y : lmin.y, (i & 4) ? lmax.z : lmin.z);
+			Vector p = transform * corner + translation;
+
+			vmin = i ? VectorMin(vmin, p) : p;
+			vmax = i ? VectorMax(vmax, p) : p;
+		}
+	}
+
+	virtual void translate(const Vector& offset)
+	{
+		translation += offset;
+	}
+
+	inline const boost::shared_ptr<Geometry>& getGeometry() const	{return geometry;}
+
+	inline const Matrix3x3& getTransform() const	{return transform;}
+	inline const Vector& getTranslation() const	{return translation;}
+	inline const Matrix3x3& getNormalMatrix() const	{return normalMatrix;}
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,118 @@
+// Object Space Ambient Occlusion Demo Project
+// (c) 2013 by L.Spiegelberg
+// This code may be redistributed or modified for any learning or teaching purposes
+// but not for any commercial uses
+// to gain further license informations please contact me via
+// spiegelb (at) in.tum.de
+
+#include <algorithm>
+#include <cmath>
+
+#include "LightGrid.h"
+#include "Stats.h"
+
+using namespace std;
+
+const int LightGrid::max_resolution;
+
+void LightGrid::build(const vector<ILight*>& lights)
+{
+	global.clear();
+	cellStart.clear();
+	cellLights.clear();
+	res[0] = res[1] = res[2] = 0;
+
+	vector<ILight*> bounded;
+	float extentSum = 0.0f;
+
+	for(vector<ILight*>::const_iterator it = lights.begin(); it != lights.end(); ++it)
+	{
+		Vector lmin, lmax;
+		if(!(*it)->getBounds(lmin, lmax))
+		{
+			global.push_back(*it);
+			continue;
+		}
+
+		bmin = bounded.empty() ? lmin : VectorMin(bmin, lmin);
+		bmax = bounded.empty() ? lmax : VectorMax(bmax, lmax);
+		extentSum += max(lmax.x - lmin.x, max(lmax.y - lmin.y, lmax.z - lmin.z));
+
+		bounded.push_back(*it);
+	}
+
+	if(bounded.empty())return;
+
+	// cells about half as large as a light, so a light covers only a few of them
+	Vector extent = bmax - bmin;
+	float longest = max(extent.x, max(extent.y, extent.z));
+
+	cellSize = max(0.5f * extentSum / (float)bounded.size(), longest / (float)max_resolution);
+	if(cellSize <= 0.0f)cellSize = 1.0f;
+	invCellSize = 1.0f / cellSize;
+
+	res[0] = max(1, min(max_resolution, (int)ceil(extent.x * invCellSize)));
+	res[1] = max(1, min(max_resolution, (int)ceil(extent.y * invCellSize)));
+	res[2] = max(1, min(max_resolution, (int)ceil(extent.z * invCellSize)));
+
+	int count = getCellCount();
+
+	// collect lights per cell, then pack them into one array
+	vector<vector<ILight*> > cells(count);
+
+	for(vector<ILight*>::iterator it = bounded.begin(); it != bounded.end(); ++it)
+	{
+		Vector lmin, lmax;
+		(*it)->getBounds(lmin, lmax);
+
+		int x0 = max(0, (int)floor((lmin.x - bmin.x) * invCellSize)), x1 = min(res[0] - 1, (int)floor((lmax.x - bmin.x) * invCellSize));
+		int y0 = max(0, (int)floor((lmin.y - bmin.y) * invCellSize)), y1 = min(res[1] - 1, (int)floor((lmax.y - bmin.y) * invCellSize));
+		int z0 = max(0, (int)floor((lmin.z - bmin.z) * invCellSize)), z1 = min(res[2] - 1, (int)floor((lmax.z - bmin.z) * invCellSize));
+
+		for(int z = z0; z <= z1; z++)
+			for(int y = y0; y <= y1; y++)
+				for(int x = x0; x <= x1; x++)
+				{
+					Vector cmin = bmin + Vector((float)x, (float)y, (float)z) * cellSize;
+					Vector cmax = cmin + Vector(cellSize, cellSize, cellSize);
+
+					if((*it)->affects(cmin, cmax))cells[cellIndex(x, y, z)].push_back(*it);
+				}
+	}
+
+	cellStart.resize(count + 1);
+	cellStart[0] = 0;
+	for(int i = 0; i < count; i++)
+	{
+		cellLights.insert(cellLights.end(), cells[i].begin(), cells[i].end());
+		cellStart[i + 1] = (int)cellLights.size();
+	}
+}
+
+Color LightGrid::shade(const Ray& r, const float fDistance, const Vector& normal, const Color& color)
+{
+	Color sum = Color::black;
+
+	for(vector<ILight*>::iterator it = global.begin(); it != global.end(); ++it)sum = sum + (*it)->shade(r, fDistance, normal, color);
+
+	STATS_ADD(lightEvaluations, global.size());
+
+	if(cellStart.empty())return sum;
+
+	// cell of the hit point, points outside of the grid are not reached by any bounded light
+	Vector p = r.origin + r.direction * fDistance;
+
+	int x = (int)floor((p.x - bmin.x) * invCellSize);
+	int y = (int)floor((p.y - bmin.y) * invCellSize);
+	int z = (int)floor((p.z - bmin.z) * invCellSize);
+
+	if(x < 0 || y < 0 || z < 0 || x >= res[0] || y >= res[1] || z >= res[2])return sum;
+
+	int cell = cellIndex(x, y, z);
+
+	for(int i = cellStart[cell]; i < cellStart[cell + 1]; i++)sum = sum + cellLights[i]->shade(r, fDistance, normal, color);
+
+	STATS_ADD(lightEvaluations, cellStart[cell + 1] - cellStart[cell]);
+
+	return sum;
+}
\ No newline at end of file
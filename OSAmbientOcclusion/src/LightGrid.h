@@ -0,0 +1,54 @@
+// Object Space Ambient Occlusion Demo Project
+// (c) 2013 by L.Spiegelberg
+// This code may be redistributed or modified for any learning or teaching purposes
+// but not for any commercial uses
+// to gain further license informations please contact me via
+// spiegelb (at) in.tum.de
+
+#ifndef LIGHTGRID_HEADER_
+#define LIGHTGRID_HEADER_
+
+#include <vector>
+
+#include "Lights.h"
+
+/// culls lights of finite range. the region reached by bounded lights is split into cells,
+/// each cell lists the lights that may reach it, so shading a point only evaluates the lights
+/// of its cell and the lights without bounds(ambient, directional)
+class LightGrid
+{
+private:
+	/// lights reaching everything
+	std::vector<ILight*>	global;
+
+	// cells over the bounds of all bounded lights
+	Vector	bmin;
+	Vector	bmax;
+	float	cellSize;
+	float	invCellSize;
+	int		res[3];
+
+	/// lights of cell i are cellLights[cellStart[i]] to cellLights[cellStart[i + 1] - 1]
+	std::vector<int>		cellStart;
+	std::vector<ILight*>	cellLights;
+
+	inline int cellIndex(const int x, const int y, const int z) const	{return x + res[0] * (y + res[1] * z);}
+
+public:
+	/// cells along the longest axis at most
+	static const int max_resolution = 64;
+
+	LightGrid():cellSize(1.0f), invCellSize(1.0f)	{res[0] = res[1] = res[2] = 0;}
+
+	/// sort lights into cells, the lights are not owned
+	void build(const std::vector<ILight*>& lights);
+
+	/// sum of the lights that may reach the hit point, like ILight::shade
+	Color shade(const Ray& r, const float fDistance, const Vector& normal, const Color& color);
+
+	/// number of cells and the number of light references in them
+	inline int getCellCount() const	{return res[0] * res[1] * res[2];}
+	inline int getReferenceCount() const	{return (int)cellLights.size();}
+};
+
+#endif
\ No newline at end of file
@@ -8,6 +8,8 @@
 #ifndef LIGHTS_HEADER_
 #define LIGHTS_HEADER_
 
+#include <cmath>
+
 #include "Ray.h"
 #include "Color.h"
 
@@ -15,8 +17,24 @@ class ILight
 {
 private:
 public:
+	virtual ~ILight()	{}
+
 	virtual Color shade(const Ray& r, const float fDistance, const Vector& normal, const Color& color)=0;
 
+	/// write light as one line of a scene description
+	virtual void write(std::ostream& out)=0;
+
+	/// bounding box of the region the light reaches, false if it reaches everything
+	virtual bool getBounds(Vector& /*vmin*/, Vector& /*vmax*/)	{return false;}
+
+	/// may the light reach a point in the box? bounded lights may test more exactly than their bounds
+	virtual bool affects(const Vector& vmin, const Vector& vmax)
+	{
+		Vector lmin, lmax;
+		if(!getBounds(lmin, lmax))return true;
+
+		return lmin.x <= vmax.x && lmax.x >= vmin.x && lmin.y <= vmax.y && lmax.y >= vmin.y && lmin.z <= vmax.z && lmax.z >= vmin.z;
+	}
 };
 
 // simple ambient light
@@ -27,12 +45,17 @@ private:
 public:
 	AmbientLight(const Color& _col):col(_col) {}
 
-	Color shade(const Ray& r, const float fDistance, const Vector& normal, const Color& color)
+	Color shade(const Ray& /*r*/, const float /*fDistance*/, const Vector& /*normal*/, const Color& color)
 	{
 		// simply multiply colors
 		return col * color;
 	}
 
+	void write(std::ostream& out)
+	{
+		out<<"ambientlight "<<col<<std::endl;
+	}
+
 };
 
 // directional light
@@ -45,7 +68,7 @@ public:
 	DirectionalLight(const Color& _col, const Vector& _dir):col(_col), dir(_dir)	{dir.normalize();}
 
 	// shade
-	Color shade(const Ray& r, const float fDistance, const Vector& normal, const Color& color)
+	Color shade(const Ray& r, const float /*fDistance*/, const Vector& normal, const Color& color)
 	{
 		// simple diffuse shading, without specularity
 		
@@ -62,6 +85,111 @@ public:
 
 		return c;
 	}
+
+	void write(std::ostream& out)
+	{
+		out<<"directionallight "<<col<<" "<<dir<<std::endl;
+	}
+};
+
+// point light, fades out smoothly up to its range
+class PointLight : public ILight
+{
+protected:
+	Color col;
+	Vector pos;
+	float range;
+
+	/// diffuse illumination of the hit point, dir is set to the direction from the light to the point
+	Color illuminate(const Ray& r, const float fDistance, const Vector& normal, const Color& color, Vector& dir)
+	{
+		dir = r.origin + r.direction * fDistance - pos;
+		float distance = VectorLength(dir);
+
+		if(distance >= range || distance == 0.0f)return Color(0.0f, 0.0f, 0.0f);
+
+		dir = dir / distance;
+
+		Vector n = normal;
+		if (n * r.direction > 0.0)
+			n *= -1.0;
+
+		float factorDiff = n * dir * -1.0;
+		if (factorDiff < 0.0)
+			return Color(0.0f, 0.0f, 0.0f);
+
+		// falls to zero at the range, so lights outside of it can be skipped
+		float attenuation = 1.0f - distance / range;
+		attenuation *= attenuation;
+
+		return color * (col * (factorDiff * attenuation));
+	}
+
+public:
+	PointLight(const Color& _col, const Vector& _pos, const float _range):col(_col), pos(_pos), range(_range)	{}
+
+	Color shade(const Ray& r, const float fDistance, const Vector& normal, const Color& color)
+	{
+		Vector dir;
+		return illuminate(r, fDistance, normal, color, dir);
+	}
+
+	void write(std::ostream& out)
+	{
+		out<<"pointlight "<<col<<" "<<pos<<" "<<range<<std::endl;
+	}
+
+	bool getBounds(Vector& vmin, Vector& vmax)
+	{
+		vmin = pos - Vector(range, range, range);
+		vmax = pos + Vector(range, range, range);
+
+		return true;
+	}
+
+	bool affects(const Vector& vmin, const Vector& vmax)
+	{
+		// distance of the box to the position
+		Vector d = VectorMax(VectorMax(vmin - pos, pos - vmax), Vector(0.0f, 0.0f, 0.0f));
+
+		return d * d < range * range;
+	}
+};
+
+// spot light, a point light limited to a cone around its direction
+class SpotLight : public PointLight
+{
+private:
+	Vector dir;
+
+	// half opening angle of the cone in degrees and its cosine
+	float angle;
+	float cosAngle;
+
+public:
+	SpotLight(const Color& _col, const Vector& _pos, const Vector& _dir, const float _range, const float _angle):
+		PointLight(_col, _pos, _range), dir(_dir), angle(_angle)
+	{
+		dir.normalize();
+		cosAngle = cos(angle * 3.14159265f / 180.0f);
+	}
+
+	Color shade(const Ray& r, const float fDistance, const Vector& normal, const Color& color)
+	{
+		Vector toPoint;
+		Color c = illuminate(r, fDistance, normal, color, toPoint);
+
+		// soft edge towards the border of the cone
+		float cosPoint = toPoint * dir;
+		if(cosPoint <= cosAngle)return Color(0.0f, 0.0f, 0.0f);
+
+		return c * ((cosPoint - cosAngle) / (1.0f - cosAngle));
+	}
+
+	void write(std::ostream& out)
+	{
+		out<<"spotlight "<<col<<" "<<pos<<" "<<dir<<" "<<range<<" "<<angle<<std::endl;
+	}
 };
 
 #endif
\ No newline at end of file
@@ -8,6 +8,8 @@
 #ifndef MATRIX_HEADER_
 #define MATRIX_HEADER_
 
+#include <cmath>
+
 #include "Vector.h"
 
 
@@ -23,7 +25,7 @@ public:
 	Matrix3x3():
 	m11(1.0f), m12(0.0f), m13(0.0),
 	m21(0.0f), m22(1.0f), m23(0.0),
-	m31(1.0f), m32(0.0f), m33(1.0)
+	m31(0.0f), m32(0.0f), m33(1.0)
 	{
 	}
 
@@ -34,6 +36,55 @@ public:
 	m13(_a3.x), m23(_a3.y), m33(_a3.z)
 	{
 	}
+
+	inline float determinant() const
+	{
+		return m11 * (m22 * m33 - m23 * m32) - m12 * (m21 * m33 - m23 * m31) + m13 * (m21 * m32 - m22 * m31);
+	}
+
+	inline Matrix3x3 getTransposed() const
+	{
+		return Matrix3x3(Vector(m11, m12, m13), Vector(m21, m22, m23), Vector(m31, m32, m33));
+	}
+
+	/// inverse via adjugate, matrix must not be singular
+	inline Matrix3x3 getInverse() const
+	{
+		float inv = 1.0f / determinant();
+
+		// columns of the inverse are the cross products of the rows
+		Vector r1(m11, m12, m13), r2(m21, m22, m23), r3(m31, m32, m33);
+
+		return Matrix3x3(r2.crossproduct(r3) * inv, r3.crossproduct(r1) * inv, r1.crossproduct(r2) * inv);
+	}
+
+	/// rotation by angle(radians) around axis
+	static Matrix3x3 rotation(const Vector& axis, const float angle)
+	{
+		Vector a = axis;
+		a.normalize();
+
+		float c = cos(angle);
+		float s = sin(angle);
+		float t = 1.0f - c;
+
+		Matrix3x3 m;
+		m.m11 = t * a.x * a.x + c;			m.m12 = t * a.x * a.y - s * a.z;	m.m13 = t * a.x * a.z + s * a.y;
+		m.m21 = t * a.x * a.y + s * a.z;	m.m22 = t * a.y * a.y + c;			m.m23 = t * a.y * a.z - s * a.x;
+		m.m31 = t * a.x * a.z - s * a.y;	m.m32 = t * a.y * a.z + s * a.x;	m.m33 = t * a.z * a.z + c;
+
+		return m;
+	}
+
+	static Matrix3x3 scale(const float sx, const float sy, const float sz)
+	{
+		Matrix3x3 m;
+		m.m11 = sx;
+		m.m22 = sy;
+		m.m33 = sz;
+
+		return m;
+	}
 };
 
 inline Vector operator * (const Matrix3x3& m, const Vector& v)
@@ -43,4 +94,20 @@ inline Vector operator * (const Matrix3x3& m, const Vector& v)
 				  m.m31 * v.x + m.m32 * v.y + m.m33 * v.z);				  
 }
 
+inline Matrix3x3 operator * (const Matrix3x3& a, const Matrix3x3& b)
+{
+	return Matrix3x3(a * Vector(b.m11, b.m21, b.m31), a * Vector(b.m12, b.m22, b.m32), a * Vector(b.m13, b.m23, b.m33));
+}
+
+// stream operators, rows one after another
+inline std::ostream& operator << (std::ostream& out, const Matrix3x3& m)
+{
+	return out<<m.m11<<" "<<m.m12<<" "<<m.m13<<" "<<m.m21<<" "<<m.m22<<" "<<m.m23<<" "<<m.m31<<" "<<m.m32<<" "<<m.m33;
+}
+
+inline std::istream& operator >> (std::istream& in, Matrix3x3& m)
+{
+	return in>>m.m11>>m.m12>>m.m13>>m.m21>>m.m22>>m.m23>>m.m31>>m.m32>>m.m33;
+}
+
 #endif
\ No newline at end of file
@@ -0,0 +1,361 @@
+// Object Space Ambient Occlusion Demo Project
+// (c) 2013 by L.Spiegelberg
+// This code may be redistributed or modified for any learning or teaching purposes
+// but not for any commercial uses
+// to gain further license informations please contact me via
+// spiegelb (at) in.tum.de
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <algorithm>
+#include <boost/thread/barrier.hpp>
+#include <boost/function.hpp>
+#include <boost/bind.hpp>
+
+#include "Numa.h"
+#include "Timer.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <sched.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+#endif
+
+using namespace std;
+
+NumaTopology *NumaTopology::topology = NULL;
+boost::once_flag NumaTopology::flag = BOOST_ONCE_INIT;
+
+#if defined(_WIN32)
+
+NumaTopology::NumaTopology()
+{
+	DWORD_PTR processMask, systemMask;
+	if(!GetProcessAffinityMask(GetCurrentProcess(), &processMask, &systemMask))processMask = ~(DWORD_PTR)0;
+
+	// only the processor group of the process
+	ULONG highest = 0;
+	if(GetNumaHighestNodeNumber(&highest))
+	{
+		for(ULONG node = 0; node <= highest; node++)
+		{
+			ULONGLONG mask = 0;
+			if(!GetNumaNodeProcessorMask((UCHAR)node, &mask))continue;
+
+			vector<int> cpus;
+			for(int cpu = 0; cpu < (int)sizeof(DWORD_PTR) * 8; cpu++)
+				if((mask & processMask) & ((DWORD_PTR)1 << cpu))cpus.push_back(cpu);
+
+			if(!cpus.empty())nodes.push_back(cpus);
+		}
+	}
+
+	if(nodes.empty())
+	{
+		nodes.resize(1);
+		for(int cpu = 0; cpu < (int)sizeof(DWORD_PTR) * 8; cpu++)
+			if(processMask & ((DWORD_PTR)1 << cpu))nodes[0].push_back(cpu);
+	}
+}
+
+bool pinThread(const int cpu)
+{
+	if(cpu < 0 || cpu >= (int)sizeof(DWORD_PTR) * 8)return false;
+
+	return SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << cpu) != 0;
+}
+
+int memoryNode(const void *p)
+{
+	return -1;
+}
+
+#elif defined(__linux__)
+
+/// parse a list of cores like 0-3,8-11
+static vector<int> parseCpuList(const string& list)
+{
+	vector<int> cpus;
+	istringstream in(list);
+	string range;
+
+	while(getline(in, range, ','))
+	{
+		int first = 0, last = 0;
+		char dash;
+		istringstream r(range);
+
+		if(!(r>>first))continue;
+		if(!(r>>dash>>last))last = first;
+
+		for(int cpu = first; cpu <= last; cpu++)cpus.push_back(cpu);
+	}
+
+	return cpus;
+}
+
+NumaTopology::NumaTopology()
+{
+	cpu_set_t allowed;
+	CPU_ZERO(&allowed);
+	bool masked = sched_getaffinity(0, sizeof(allowed), &allowed) == 0;
+
+	// nodes are numbered without gaps on almost all machines, stop at the first missing one
+	for(int node = 0; ; node++)
+	{
+		ostringstream name;
+		name<<"/sys/devices/system/node/node"<<node<<"/cpulist";
+
+		ifstream file(name.str().c_str());
+		if(!file)break;
+
+		string list;
+		getline(file, list);
+
+		vector<int> all = parseCpuList(list), cpus;
+		for(unsigned int i = 0; i < all.size(); i++)
+			if(!masked || (all[i] < CPU_SETSIZE && CPU_ISSET(all[i], &allowed)))cpus.push_back(all[i]);
+
+		if(!cpus.empty())nodes.push_back(cpus);
+	}
+
+	// no NUMA information, one node with all cores we may use
+	if(nodes.empty())
+	{
+		nodes.resize(1);
+		int count = max(1, (int)boost::thread::hardware_concurrency());
+
+		for(int cpu = 0; cpu < (masked ? CPU_SETSIZE : count); cpu++)
+			if(!masked || CPU_ISSET(cpu, &allowed))nodes[0].push_back(cpu);
+	}
+}
+
+bool pinThread(const int cpu)
+{
+	if(cpu < 0 || cpu >= CPU_SETSIZE)return false;
+
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	CPU_SET(cpu, &set);
+
+	return sched_setaffinity(0, sizeof(set), &set) == 0;
+}
+
+int memoryNode(const void *p)
+{
+	// move_pages without target nodes only reports where the pages are
+	long pageSize = sysconf(_SC_PAGESIZE);
+	void *page = (void*)((size_t)p & ~(size_t)(pageSize - 1));
+	int status = -1;
+
+	if(syscall(SYS_move_pages, 0, 1UL, &page, NULL, &status, 0) != 0)return -1;
+
+	return status >= 0 ? status : -1;
+}
+
+#else
+
+NumaTopology::NumaTopology()
+{
+	nodes.resize(1);
+	for(int cpu = 0; cpu < max(1, (int)boost::thread::hardware_concurrency()); cpu++)nodes[0].push_back(cpu);
+}
+
+bool pinThread(const int cpu)
+{
+	return false;
+}
+
+int memoryNode(const void *p)
+{
+	return -1;
+}
+
+#endif
+
+int NumaTopology::nodeOf(const int cpu) const
+{
+	for(unsigned int node = 0; node < nodes.size(); node++)
+		if(find(nodes[node].begin(), nodes[node].end(), cpu) != nodes[node].end())return (int)node;
+
+	return 0;
+}
+
+vector<int> NumaTopology::workerCpus(const int threads) const
+{
+	vector<int> all;
+	for(unsigned int node = 0; node < nodes.size(); node++)all.insert(all.end(), nodes[node].begin(), nodes[node].end());
+
+	// spread threads evenly over the cores, so with fewer threads than cores every node gets some
+	vector<int> res(threads);
+	for(int i = 0; i < threads; i++)
+		res[i] = threads <= (int)all.size() ? all[(long long)i * all.size() / threads] : all[i % all.size()];
+
+	return res;
+}
+
+/// floats per buffer of the bandwidth benchmark(128 MB)
+static const int bandwidth_floats = 32 << 20;
+
+/// passes over a buffer per measurement
+static const int bandwidth_passes = 4;
+
+/// write a part of the buffer, its pages are placed on the node of the writing core
+static void touchPart(float *data, const int begin, const int end)
+{
+	fill(data + begin, data + end, 1.0f);
+}
+
+/// read a part of the buffer several times
+static void readPart(const float *data, const int begin, const int end, float& result)
+{
+	float sum[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+
+	for(int pass = 0; pass < bandwidth_passes; pass++)
+		for(int i = begin; i + 3 < end; i += 4)
+		{
+			sum[0] += data[i];
+			sum[1] += data[i + 1];
+			sum[2] += data[i + 2];
+			sum[3] += data[i + 3];
+		}
+
+	result = sum[0] + sum[1] + sum[2] + sum[3];
+}
+
+static void nodeWorker(const int cpu, boost::barrier& ready, const boost::function<void (int)>& func, const int index)
+{
+	pinThread(cpu);
+	ready.wait();
+
+	func(index);
+}
+
+/// call func(index) on all cores of a node, returns seconds until all are done
+static double onNode(const vector<int>& cpus, const boost::function<void (int)>& func)
+{
+	boost::barrier ready((unsigned int)cpus.size() + 1);
+	boost::thread_group threads;
+
+	for(unsigned int i = 0; i < cpus.size(); i++)
+		threads.create_thread(boost::bind(nodeWorker, cpus[i], boost::ref(ready), boost::cref(func), (int)i));
+
+	// threads are started and pinned, only the memory access is measured
+	ready.wait();
+	Timer timer;
+	threads.join_all();
+
+	return timer.elapsed();
+}
+
+/// part index of count equal parts of the buffer
+static inline int partBegin(const int index, const int count)	{return (int)((long long)bandwidth_floats * index / count);}
+
+static void touchIndex(float *data, const int count, const int index)
+{
+	touchPart(data, partBegin(index, count), partBegin(index + 1, count));
+}
+
+static void readIndex(const float *data, vector<float>& results, const int index)
+{
+	int count = (int)results.size();
+	readPart(data, partBegin(index, count), partBegin(index + 1, count), results[index]);
+}
+
+bool RunBandwidthBenchmark()
+{
+	const NumaTopology& topology = NumaTopology::instance();
+	int nodes = topology.nodeCount();
+
+	cout<<nodes<<" NUMA node(s)"<<endl;
+	for(int node = 0; node < nodes; node++)
+	{
+		cout<<"  node "<<node<<":";
+		for(unsigned int i = 0; i < topology.cpus(node).size(); i++)cout<<" "<<topology.cpus(node)[i];
+		cout<<endl;
+	}
+
+	if(!pinThread(topology.cpus(0)[0]))
+	{
+		cout<<"threads can not be pinned to cores on this platform"<<endl;
+		return false;
+	}
+
+	// one buffer per node, first touched by the cores of that node
+	vector<float*> buffers(nodes);
+	for(int node = 0; node < nodes; node++)
+	{
+		buffers[node] = new float[bandwidth_floats];
+
+		onNode(topology.cpus(node), boost::bind(touchIndex, buffers[node], (int)topology.cpus(node).size(), _1));
+
+		// check where the pages ended up, every 256th page is enough
+		int pages = 0, local = 0;
+		for(int i = 0; i < bandwidth_floats; i += 256 * 1024)
+		{
+			pages++;
+			if(memoryNode(buffers[node] + i) == node)local++;
+		}
+
+		cout<<"buffer of node "<<node<<": ";
+		if(memoryNode(buffers[node]) < 0)cout<<"page placement unknown"<<endl;
+		else cout<<100 * local / pages<<"% of the sampled pages on node "<<node<<endl;
+	}
+
+	// read bandwidth in GB/s of the cores of each node(rows) from the buffer of each node(columns)
+	vector<vector<double> > bandwidth(nodes, vector<double>(nodes, 0.0));
+	double checksum = 0.0;
+
+	for(int cpuNode = 0; cpuNode < nodes; cpuNode++)
+		for(int memNode = 0; memNode < nodes; memNode++)
+		{
+			vector<float> results(topology.cpus(cpuNode).size());
+
+			// best of three
+			double best = 1e30;
+			for(int run = 0; run < 3; run++)
+				best = min(best, onNode(topology.cpus(cpuNode), boost::bind(readIndex, buffers[memNode], boost::ref(results), _1)));
+
+			for(unsigned int i = 0; i < results.size(); i++)checksum += results[i];
+
+			bandwidth[cpuNode][memNode] = (double)bandwidth_floats * sizeof(float) * bandwidth_passes / best / 1e9;
+		}
+
+	for(int node = 0; node < nodes; node++)delete [] buffers[node];
+
+	cout<<"read bandwidth in GB/s, cores of a node(rows) from memory of a node(columns):"<<endl;
+	cout<<fixed<<setprecision(2);
+	for(int cpuNode = 0; cpuNode < nodes; cpuNode++)
+	{
+		cout<<"  node "<<cpuNode<<":";
+		for(int memNode = 0; memNode < nodes; memNode++)cout<<" "<<setw(8)<<bandwidth[cpuNode][memNode];
+
+		// average remote bandwidth relative to local
+		if(nodes > 1)
+		{
+			double remote = 0.0;
+			for(int memNode = 0; memNode < nodes; memNode++)
+				if(memNode != cpuNode)remote += bandwidth[cpuNode][memNode];
+			remote /= (double)(nodes - 1);
+
+			cout<<"   remote/local "<<remote / bandwidth[cpuNode][cpuNode];
+		}
+		cout<<endl;
+	}
+	cout.unsetf(ios::floatfield);
+
+	if(nodes == 1)cout<<"single node, there is no remote memory to compare with"<<endl;
+
+	// keeps the reads from being optimized away
+	if(checksum < 0.0)cout<<checksum<<endl;
+
+	return true;
+}
\ No newline at end of file
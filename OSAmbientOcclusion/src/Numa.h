@@ -0,0 +1,71 @@
+// Object Space Ambient Occlusion Demo Project
+// (c) 2013 by L.Spiegelberg
+// This code may be redistributed or modified for any learning or teaching purposes
+// but not for any commercial uses
+// to gain further license informations please contact me via
+// spiegelb (at) in.tum.de
+
+#ifndef NUMA_HEADER_
+#define NUMA_HEADER_
+
+#include <vector>
+#include <boost/thread.hpp>
+
+// on machines with several sockets each socket has its own memory(a NUMA node), reading the memory
+// of another node goes over the interconnect and is slower. the operating system places a page on
+// the node of the thread that writes it first, so with --numa the render threads are pinned to cores
+// and every thread clears the tiles it renders itself
+
+/// cores and NUMA nodes the process may run on
+class NumaTopology
+{
+private:
+	/// logical cores of each node, only the ones in the affinity mask of the process
+	std::vector<std::vector<int> >	nodes;
+
+	static NumaTopology				*topology;
+	static boost::once_flag			flag;
+
+	static void create()	{topology = new NumaTopology();}
+
+	NumaTopology();
+
+public:
+	/// topology of the machine, detected on first use
+	static NumaTopology& instance()
+	{
+		boost::call_once(&NumaTopology::create, flag);
+		return *topology;
+	}
+
+	inline int nodeCount() const	{return (int)nodes.size();}
+
+	/// cores of a node
+	inline const std::vector<int>& cpus(const int node) const	{return nodes[node];}
+
+	/// node of a core, 0 if unknown
+	int nodeOf(const int cpu) const;
+
+	/// core for each of threads render threads. cores are taken node by node, so neighbouring threads
+	/// (which own neighbouring tiles) share a node. more threads than cores wrap around
+	std::vector<int> workerCpus(const int threads) const;
+};
+
+/// bind the calling thread to a logical core, returns false if this is not supported
+bool pinThread(const int cpu);
+
+/// node the page of address p is placed on, -1 if it is not known(e.g. not touched yet or not supported)
+int memoryNode(const void *p);
+
+/// thread owning item index if count items are split into equal blocks of consecutive items.
+/// tiles are numbered row by row, so a block of tiles covers consecutive image rows
+inline int blockOwner(const int index, const int count, const int threads)
+{
+	return (int)(((long long)index * threads) / count);
+}
+
+/// measure read bandwidth of the cores of each node from memory placed on each node, returns false
+/// if threads can not be pinned
+bool RunBandwidthBenchmark();
+
+#endif
\ No newline at end of file
@@ -17,9 +17,39 @@
 class IObject
 {
 private:
+	/// index in the scene list, set when the acceleration structures are built
+	int id;
+
 public:
+	IObject():id(0)	{}
+	virtual ~IObject()	{}
+
+	inline int getId() const	{return id;}
+	inline void setId(const int _id)	{id = _id;}
+
 	/// intersect with ray, output distance, color, tangent
 	virtual bool intersect(const Ray& r, float& fDistance, Vector& normal, Color& color) = 0;
+
+	/// write object as one line of a scene description
+	virtual void write(std::ostream& out) = 0;
+
+	/// axis aligned bounding box
+	virtual void getBounds(Vector& vmin, Vector& vmax) = 0;
+
+	/// move object, the acceleration structures have to be built again afterwards
+	virtual void translate(const Vector& offset) = 0;
+
+	/// may the surface of the object intersect the box? used to sort objects into
+	/// grid cells, has to be conservative(default: bounding boxes overlap)
+	virtual bool overlaps(const Vector& vmin, const Vector& vmax)
+	{
+		Vector bmin, bmax;
+		getBounds(bmin, bmax);
+
+		return bmin.x <= vmax.x && bmax.x >= vmin.x &&
+			   bmin.y <= vmax.y && bmax.y >= vmin.y &&
+			   bmin.z <= vmax.z && bmax.z >= vmin.z;
+	}
 };
 
 // two Objects
@@ -92,6 +122,38 @@ public:
 		
 		return true;
 	}
+
+	inline const Vector& getCenter() const	{return center;}
+	inline float getRadius() const	{return radius;}
+
+	virtual void write(std::ostream& out)
+	{
+		out<<"sphere "<<radius<<" "<<center<<" "<<color<<std::endl;
+	}
+
+	virtual void getBounds(Vector& vmin, Vector& vmax)
+	{
+		vmin = center - Vector(radius, radius, radius);
+		vmax = center + Vector(radius, radius, radius);
+	}
+
+	virtual void translate(const Vector& offset)
+	{
+		center += offset;
+	}
+
+	virtual bool overlaps(const Vector& vmin, const Vector& vmax)
+	{
+		// nearest and farthest point of the box have to lie on different sides of the surface
+		Vector nearest = VectorMin(VectorMax(center, vmin), vmax);
+		Vector farthest = Vector(center.x < (vmin.x + vmax.x) * 0.5f ? vmax.x : vmin.x,
+								 center.y < (vmin.y + vmax.y) * 0.5f ? vmax.y : vmin.y,
+								 center.z < (vmin.z + vmax.z) * 0.5f ? vmax.z : vmin.z);
+
+		float r2 = radius * radius;
+
+		return (nearest - center) * (nearest - center) <= r2 && (farthest - center) * (farthest - center) >= r2;
+	}
 };
 
 
@@ -210,6 +272,38 @@ public:
 
 	inline Vector getNearPoint()	{return center - Vector(halfSize[0], halfSize[1], halfSize[2]);}
 	inline Vector getFarPoint()		{return center + Vector(halfSize[0], halfSize[1], halfSize[2]);}
+
+	virtual void write(std::ostream& out)
+	{
+		out<<"box "<<getNearPoint()<<" "<<getFarPoint()<<" "<<col<<std::endl;
+	}
+
+	virtual void getBounds(Vector& vmin, Vector& vmax)
+	{
+		vmin = getNearPoint();
+		vmax = getFarPoint();
+	}
+
+	virtual void translate(const Vector& offset)
+	{
+		center += offset;
+	}
+
+	virtual bool overlaps(const Vector& vmin, const Vector& vmax)
+	{
+		Vector bmin = getNearPoint();
+		Vector bmax = getFarPoint();
+
+		// boxes have to overlap
+		if(bmin.x > vmax.x || bmax.x < vmin.x ||
+		   bmin.y > vmax.y || bmax.y < vmin.y ||
+		   bmin.z > vmax.z || bmax.z < vmin.z)return false;
+
+		// but the box must not lie completely inside(no surface there)
+		return !(vmin.x > bmin.x && vmax.x < bmax.x &&
+				 vmin.y > bmin.y && vmax.y < bmax.y &&
+				 vmin.z > bmin.z && vmax.z < bmax.z);
+	}
 };
 
 
@@ -267,12 +361,37 @@ public:
 		fDistance = (vEdge2 * vQ);
 		
 		fDistance *= fInvDet;
+
+		// triangle behind ray origin
+		if(fDistance < 0.0f)return false;
 		
 		normal = n;
 		color = col;
 
 		return true;
 	}
+
+	/// corner i(0, 1 or 2)
+	inline const Vector& getVertex(const int i) const	{return i == 0 ? v0 : (i == 1 ? v1 : v2);}
+	inline const Vector& getNormal() const	{return n;}
+
+	virtual void write(std::ostream& out)
+	{
+		out<<"triangle "<<v0<<" "<<v1<<" "<<v2<<" "<<col<<std::endl;
+	}
+
+	virtual void getBounds(Vector& vmin, Vector& vmax)
+	{
+		vmin = VectorMin(VectorMin(v0, v1), v2);
+		vmax = VectorMax(VectorMax(v0, v1), v2);
+	}
+
+	virtual void translate(const Vector& offset)
+	{
+		v0 += offset;
+		v1 += offset;
+		v2 += offset;
+	}
 };
 
 #endif
\ No newline at end of file
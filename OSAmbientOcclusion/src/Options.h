@@ -0,0 +1,575 @@
+// Object Space Ambient Occlusion Demo Project
+// (c) 2013 by L.Spiegelberg
+// This code may be redistributed or modified for any learning or teaching purposes
+// but not for any commercial uses
+// to gain further license informations please contact me via
+// spiegelb (at) in.tum.de
+
+#ifndef OPTIONS_HEADER_
+#define OPTIONS_HEADER_
+
+#include <iostream>
+#include <string>
+#include <cstring>
+#include <cstdlib>
+#include <vector>
+#include <algorithm>
+
+/// settings given on the command line
+struct RenderOptions
+{
+	/// size of the image
+	int width;
+	int height;
+
+	/// render the image tile by tile, only the tiles are held in memory
+	bool tiled;
+	int tileSize;
+
+	/// file to write the final image to(headless mode)
+	std::string output;
+
+	/// distribute tiles to worker processes connecting to this port
+	int coordinatorPort;
+
+	/// render tiles for the coordinator at host:port
+	std::string worker;
+
+	/// print render statistics at the end
+	bool stats;
+
+	/// write render statistics as JSON to this file
+	std::string statsFile;
+
+	/// number of render threads
+	int threads;
+
+	/// rays per pixel for ambient occlusion
+	int aoSamples;
+
+	/// objects farther away than this do not occlude
+	float aoRadius;
+
+	/// acceleration structures(linear, grid, bvh) for camera rays and ambient occlusion rays
+	std::string primaryAccel;
+	std::string aoAccel;
+
+	/// grid cell size relative to aoRadius
+	float gridCellScale;
+
+	/// run benchmark and write results to this file(.csv or .json)
+	std::string benchmark;
+
+	// benchmark sweeps over all combinations of these
+	std::vector<std::string>	benchTypes;
+	std::vector<int>			benchObjects;
+	std::vector<int>			benchSizes;
+	std::vector<int>			benchSamples;
+	std::vector<int>			benchThreads;
+
+	/// runs per configuration, the median is reported
+	int benchRepeat;
+
+	/// scale image size with thread count(weak scaling)
+	bool benchWeak;
+
+	/// point lights added to every benchmark scene
+	int benchLights;
+
+	/// shade only with the lights whose range reaches the hit point
+	bool lightCulling;
+
+	/// render a camera flight along the key frames in this file, output is a file name pattern
+	std::string animation;
+	int frames;
+
+	/// reuse ambient occlusion of the previous frame
+	bool reprojection;
+
+	/// ambient occlusion samples per frame for new pixels, 0 = a quarter of aoSamples
+	int temporalStep;
+
+	/// ambient occlusion is computed for one pixel of each aoScale x aoScale block and upsampled
+	int aoScale;
+
+	/// how ambient occlusion is computed: rays, analytic for spheres and boxes(rays for the other objects) or surfels
+	std::string aoMethod;
+
+	/// surfel edge length relative to the ao radius, clusters are used as one disk below this ratio of radius to distance
+	float surfelSize;
+	float surfelError;
+
+	/// camera rays per pixel are aaGrid x aaGrid, the ambient occlusion is blurred with a blurSize x blurSize box filter
+	int aaGrid;
+	int blurSize;
+
+	/// compute bent normals, mean unoccluded directions and obscurance along with the ambient occlusion
+	bool aoOutputs;
+
+	/// run the passes of a frame as a graph of tile tasks instead of one after another
+	bool pipeline;
+
+	/// trace the ambient occlusion rays of a tile sorted by origin and direction instead of per pixel
+	bool wavefront;
+
+	/// show a coarse image first and refine it, publishing the current state every budget milliseconds
+	bool progressive;
+	int budget;
+
+	/// memory mapped file the final image(and the layers in sharedLayers) is rendered into, e.g. /dev/shm/osao
+	std::string sharedFramebuffer;
+	std::vector<std::string> sharedLayers;
+
+	/// encode and write output tiles on an own thread while rendering continues
+	bool asyncOutput;
+
+	/// keep the scene loaded and serve render requests on this unix socket
+	std::string server;
+
+	/// move objects of the scene this often and render only the affected pixels after each edit
+	int benchEdits;
+
+	/// pin render threads to cores and place the memory of the tiles on the NUMA node of the thread rendering them
+	bool numa;
+
+	/// measure local and remote memory bandwidth of the NUMA nodes
+	bool benchNuma;
+
+	/// record the render cost of each pixel and write heatmaps of these metrics(time, rays, tests)
+	std::vector<std::string> heatmap;
+
+	/// write a timeline of passes, tiles and lock waits of all threads as Chrome trace JSON to this file
+	std::string trace;
+
+	/// convert this compressed tile file(.osat) to the binary PPM given as output instead of rendering
+	std::string decode;
+
+	RenderOptions(const int _width, const int _height)
+	{
+		width			= _width;
+		height			= _height;
+		tiled			= false;
+		tileSize		= 64;
+		coordinatorPort	= 0;
+		stats			= false;
+		threads			= 1;
+		aoSamples		= 256;
+		aoRadius		= 0.4f;
+		primaryAccel	= "bvh";
+		aoAccel			= "grid";
+		gridCellScale	= 1.0f;
+		benchRepeat		= 3;
+		benchWeak		= false;
+		benchLights		= 0;
+		lightCulling	= true;
+		frames			= 30;
+		reprojection	= true;
+		temporalStep	= 0;
+		aoScale			= 1;
+		aoMethod		= "rays";
+		surfelSize		= 0.1f;
+		surfelError		= 0.25f;
+		aaGrid			= 5;
+		blurSize		= 9;
+		aoOutputs		= false;
+		pipeline		= true;
+		wavefront		= false;
+		progressive		= false;
+		budget			= 100;
+		asyncOutput		= true;
+		benchEdits		= 0;
+		numa			= false;
+		benchNuma		= false;
+	}
+
+	/// no window is opened if an output file is given, if running as worker or benchmark
+	inline bool headless() const	{return !output.empty() || !worker.empty() || !benchmark.empty() || !animation.empty() || !server.empty() || benchEdits || benchNuma;}
+};
+
+/// print command line help
+inline void printUsage(const char *name)
+{
+	std::cout<<"usage: "<<name<<" [options]"<<std::endl
+		<<"  -w, --width <n>       image width"<<std::endl
+		<<"  -h, --height <n>      image height"<<std::endl
+		<<"  -o, --output <file>   render headless and write the final image as binary PPM, or as zlib compressed"<<std::endl
+		<<"                        float tiles if file ends with .osat"<<std::endl
+		<<"  --tiled               render tile by tile with bounded memory(needs --output)"<<std::endl
+		<<"  --tile-size <n>       edge length of a tile(default 64)"<<std::endl
+		<<"  --coordinator <port>  hand out tiles to worker processes connecting to port(needs --output)"<<std::endl
+		<<"  --worker <host:port>  render tiles for a coordinator"<<std::endl
+		<<"  --stats               print render statistics(rays, intersection tests, pass timings)"<<std::endl
+		<<"  --stats-json <file>   write render statistics as JSON"<<std::endl
+		<<"  --threads <n>         number of render threads(0 = all cores, default 1)"<<std::endl
+		<<"  --ao-samples <n>      ambient occlusion rays per pixel(default 256)"<<std::endl
+		<<"  --ao-radius <r>       distance up to which objects occlude(default 0.4)"<<std::endl
+		<<"  --primary-accel <a>   acceleration structure for camera rays: linear, grid, bvh(default bvh)"<<std::endl
+		<<"  --ao-accel <a>        acceleration structure for ambient occlusion rays(default grid)"<<std::endl
+		<<"  --grid-cell <f>       grid cell size relative to the ao radius(default 1)"<<std::endl
+		<<"  --benchmark <file>    render procedural scenes headless and write timings(.csv or .json)"<<std::endl
+		<<"  --bench-types <list>  object types, e.g. sphere,box,triangle,mixed,instance(default sphere)"<<std::endl
+		<<"  --bench-objects <list> object counts, e.g. 10,100,1000(default 10,100,1000)"<<std::endl
+		<<"  --bench-sizes <list>  image edge lengths(default 64,128)"<<std::endl
+		<<"  --bench-samples <list> ambient occlusion samples(default 16,64)"<<std::endl
+		<<"  --bench-threads <list> thread counts(default 1,2,4)"<<std::endl
+		<<"  --bench-repeat <n>    runs per configuration, the median is reported(default 3)"<<std::endl
+		<<"  --bench-weak          scale image area with the thread count(weak scaling)"<<std::endl
+		<<"  --bench-lights <n>    point lights of limited range added to every scene(default 0)"<<std::endl
+		<<"  --no-light-culling    shade every hit with all lights instead of the ones reaching it"<<std::endl
+		<<"  --animation <file>    render a camera flight, each line of file holds a key frame <position> <lookat>,"<<std::endl
+		<<"                        frames are written to --output which has to contain a number format like %03d"<<std::endl
+		<<"  --frames <n>          frames of the animation(default 30)"<<std::endl
+		<<"  --no-reprojection     compute ambient occlusion of every frame from scratch"<<std::endl
+		<<"  --temporal-step <n>   ambient occlusion samples per frame for new pixels(default ao samples / 4)"<<std::endl
+		<<"  --ao-scale <n>        compute ambient occlusion at 1/n resolution(1, 2 or 4) and upsample it(default 1)"<<std::endl
+		<<"  --ao-method <m>       rays, or analytic: closed form occlusion of spheres and boxes without noise,"<<std::endl
+		<<"                        other objects are still sampled with rays, or surfels: all surfaces are covered"<<std::endl
+		<<"                        with disks whose occlusion is summed over a cluster hierarchy(default rays)"<<std::endl
+		<<"  --surfel-size <f>     surfel edge length relative to the ao radius(default 0.1)"<<std::endl
+		<<"  --surfel-error <f>    clusters smaller than this ratio of their distance are one disk, lower is more"<<std::endl
+		<<"                        accurate and slower(0 - 1, default 0.25)"<<std::endl
+		<<"  --aa <n>              antialiasing with n x n camera rays per pixel(default 5)"<<std::endl
+		<<"  --blur-size <n>       edge length of the ambient occlusion blur, odd(default 9)"<<std::endl
+		<<"  --ao-outputs          also compute bent normals, mean unoccluded directions and obscurance(F6-F8),"<<std::endl
+		<<"                        written next to --output as <name>_bent, <name>_unoccluded and <name>_obscurance"<<std::endl
+		<<"  --no-pipeline         render the passes of a frame one after another instead of overlapping them per tile"<<std::endl
+		<<"  --wavefront           trace the ambient occlusion rays of a tile sorted by origin cell and direction"<<std::endl
+		<<"                        (pipelined full frames only)"<<std::endl
+		<<"  --progressive         show a coarse preview first and refine it"<<std::endl
+		<<"  --budget <ms>         time between two refined images in progressive mode(default 100)"<<std::endl
+		<<"  --shared-framebuffer <file>"<<std::endl
+		<<"                        render into a memory mapped file other processes can read, e.g. /dev/shm/osao"<<std::endl
+		<<"  --shared-layers <list> further layers of the shared framebuffer: ao, depth"<<std::endl
+		<<"  --sync-output         write output tiles on the render threads instead of an own I/O thread"<<std::endl
+		<<"  --server <path>       keep the scene loaded and render requests received on the unix socket path"<<std::endl
+		<<"  --bench-edits <n>     move objects n times and render only the pixels each edit affects"<<std::endl
+		<<"  --numa                pin render threads to cores and let each thread place the memory of its tiles"<<std::endl
+		<<"                        on its NUMA node, tiles keep their thread in all passes(pipelined rendering)"<<std::endl
+		<<"  --bench-numa          measure memory bandwidth of each NUMA node from local and remote memory"<<std::endl
+		<<"  --heatmap <list>      record render time, rays and intersection tests of each pixel(F9-F11) and write"<<std::endl
+		<<"                        heatmaps of the listed metrics next to --output as <name>_heat_<metric>"<<std::endl
+		<<"  --trace <file>        write a timeline of passes, tiles and lock waits as Chrome trace JSON(chrome://tracing,"<<std::endl
+		<<"                        ui.perfetto.dev)"<<std::endl
+		<<"  --decode <file>       convert a compressed tile file(.osat) to the binary PPM given by --output"<<std::endl;
+}
+
+/// parse comma separated list of numbers
+inline std::vector<int> parseIntList(const char *str)
+{
+	std::vector<int> res;
+
+	while(*str)
+	{
+		res.push_back(atoi(str));
+
+		str = strchr(str, ',');
+		if(!str)break;
+		str++;
+	}
+
+	return res;
+}
+
+/// parse comma separated list of words
+inline std::vector<std::string> parseStringList(const char *str)
+{
+	std::vector<std::string> res;
+	std::string s = str;
+	size_t start = 0;
+
+	while(start <= s.size())
+	{
+		size_t end = s.find(',', start);
+		if(end == std::string::npos)end = s.size();
+
+		if(end > start)res.push_back(s.substr(start, end - start));
+		start = end + 1;
+	}
+
+	return res;
+}
+
+/// is pattern a file name with exactly one frame number conversion %d(optionally with zero flag and width,
+/// e.g. %03d) and otherwise only %% as format characters, so it is safe to pass to snprintf with one int
+inline bool isFramePattern(const std::string& pattern)
+{
+	int conversions = 0;
+
+	for(size_t i = 0; i < pattern.size(); i++)
+	{
+		if(pattern[i] != '%')continue;
+
+		i++;
+		if(i < pattern.size() && pattern[i] == '%')continue;
+
+		if(i < pattern.size() && pattern[i] == '0')i++;
+		while(i < pattern.size() && pattern[i] >= '0' && pattern[i] <= '9')i++;
+
+		if(i >= pattern.size() || pattern[i] != 'd')return false;
+		conversions++;
+	}
+
+	return conversions == 1;
+}
+
+/// parse command line, returns false if arguments are invalid
+inline bool parseOptions(int argc, char *argv[], RenderOptions& options)
+{
+	for(int i = 1; i < argc; i++)
+	{
+		const char *arg = argv[i];
+
+		// options with a value
+		bool hasValue = i + 1 < argc;
+
+		if(!strcmp(arg, "--help"))return false;
+		else if((!strcmp(arg, "-w") || !strcmp(arg, "--width")) && hasValue)options.width = atoi(argv[++i]);
+		else if((!strcmp(arg, "-h") || !strcmp(arg, "--height")) && hasValue)options.height = atoi(argv[++i]);
+		else if((!strcmp(arg, "-o") || !strcmp(arg, "--output")) && hasValue)options.output = argv[++i];
+		else if(!strcmp(arg, "--tiled"))options.tiled = true;
+		else if(!strcmp(arg, "--tile-size") && hasValue)options.tileSize = atoi(argv[++i]);
+		else if(!strcmp(arg, "--coordinator") && hasValue)options.coordinatorPort = atoi(argv[++i]);
+		else if(!strcmp(arg, "--worker") && hasValue)options.worker = argv[++i];
+		else if(!strcmp(arg, "--stats"))options.stats = true;
+		else if(!strcmp(arg, "--stats-json") && hasValue)options.statsFile = argv[++i];
+		else if(!strcmp(arg, "--threads") && hasValue)options.threads = atoi(argv[++i]);
+		else if(!strcmp(arg, "--ao-samples") && hasValue)options.aoSamples = atoi(argv[++i]);
+		else if(!strcmp(arg, "--ao-radius") && hasValue)options.aoRadius = (float)atof(argv[++i]);
+		else if(!strcmp(arg, "--primary-accel") && hasValue)options.primaryAccel = argv[++i];
+		else if(!strcmp(arg, "--ao-accel") && hasValue)options.aoAccel = argv[++i];
+		else if(!strcmp(arg, "--grid-cell") && hasValue)options.gridCellScale = (float)atof(argv[++i]);
+		else if(!strcmp(arg, "--benchmark") && hasValue)options.benchmark = argv[++i];
+		else if(!strcmp(arg, "--bench-types") && hasValue)options.benchTypes = parseStringList(argv[++i]);
+		else if(!strcmp(arg, "--bench-objects") && hasValue)options.benchObjects = parseIntList(argv[++i]);
+		else if(!strcmp(arg, "--bench-sizes") && hasValue)options.benchSizes = parseIntList(argv[++i]);
+		else if(!strcmp(arg, "--bench-samples") && hasValue)options.benchSamples = parseIntList(argv[++i]);
+		else if(!strcmp(arg, "--bench-threads") && hasValue)options.benchThreads = parseIntList(argv[++i]);
+		else if(!strcmp(arg, "--bench-repeat") && hasValue)options.benchRepeat = atoi(argv[++i]);
+		else if(!strcmp(arg, "--bench-weak"))options.benchWeak = true;
+		else if(!strcmp(arg, "--bench-lights") && hasValue)options.benchLights = atoi(argv[++i]);
+		else if(!strcmp(arg, "--no-light-culling"))options.lightCulling = false;
+		else if(!strcmp(arg, "--animation") && hasValue)options.animation = argv[++i];
+		else if(!strcmp(arg, "--frames") && hasValue)options.frames = atoi(argv[++i]);
+		else if(!strcmp(arg, "--no-reprojection"))options.reprojection = false;
+		else if(!strcmp(arg, "--temporal-step") && hasValue)options.temporalStep = atoi(argv[++i]);
+		else if(!strcmp(arg, "--ao-scale") && hasValue)options.aoScale = atoi(argv[++i]);
+		else if(!strcmp(arg, "--ao-method") && hasValue)options.aoMethod = argv[++i];
+		else if(!strcmp(arg, "--surfel-size") && hasValue)options.surfelSize = (float)atof(argv[++i]);
+		else if(!strcmp(arg, "--surfel-error") && hasValue)options.surfelError = (float)atof(argv[++i]);
+		else if(!strcmp(arg, "--aa") && hasValue)options.aaGrid = atoi(argv[++i]);
+		else if(!strcmp(arg, "--blur-size") && hasValue)options.blurSize = atoi(argv[++i]);
+		else if(!strcmp(arg, "--ao-outputs"))options.aoOutputs = true;
+		else if(!strcmp(arg, "--no-pipeline"))options.pipeline = false;
+		else if(!strcmp(arg, "--wavefront"))options.wavefront = true;
+		else if(!strcmp(arg, "--progressive"))options.progressive = true;
+		else if(!strcmp(arg, "--budget") && hasValue)options.budget = atoi(argv[++i]);
+		else if(!strcmp(arg, "--shared-framebuffer") && hasValue)options.sharedFramebuffer = argv[++i];
+		else if(!strcmp(arg, "--shared-layers") && hasValue)options.sharedLayers = parseStringList(argv[++i]);
+		else if(!strcmp(arg, "--sync-output"))options.asyncOutput = false;
+		else if(!strcmp(arg, "--server") && hasValue)options.server = argv[++i];
+		else if(!strcmp(arg, "--bench-edits") && hasValue)options.benchEdits = atoi(argv[++i]);
+		else if(!strcmp(arg, "--numa"))options.numa = true;
+		else if(!strcmp(arg, "--bench-numa"))options.benchNuma = true;
+		else if(!strcmp(arg, "--heatmap") && hasValue)options.heatmap = parseStringList(argv[++i]);
+		else if(!strcmp(arg, "--trace") && hasValue)options.trace = argv[++i];
+		else if(!strcmp(arg, "--decode") && hasValue)options.decode = argv[++i];
+		else
+		{
+			std::cout<<"unknown or incomplete option "<<arg<<std::endl;
+			return false;
+		}
+	}
+
+	// check values
+	if(options.width <= 0 || options.height <= 0)
+	{
+		std::cout<<"invalid image size"<<std::endl;
+		return false;
+	}
+
+	if(options.threads < 0 || options.aoSamples <= 0 || options.benchRepeat <= 0 || options.benchLights < 0)
+	{
+		std::cout<<"invalid thread count, sample count, repeat count or light count"<<std::endl;
+		return false;
+	}
+
+	if(options.aoRadius <= 0.0f || options.gridCellScale <= 0.0f)
+	{
+		std::cout<<"invalid ao radius or grid cell size"<<std::endl;
+		return false;
+	}
+
+	if(options.aoMethod != "rays" && options.aoMethod != "analytic" && options.aoMethod != "surfels")
+	{
+		std::cout<<"unknown ao method "<<options.aoMethod<<std::endl;
+		return false;
+	}
+
+	if(options.surfelSize <= 0.0f || options.surfelError < 0.0f || options.surfelError > 1.0f)
+	{
+		std::cout<<"invalid surfel size or error"<<std::endl;
+		return false;
+	}
+
+	if(options.aoMethod != "rays" && (options.wavefront || options.aoOutputs))
+	{
+		std::cout<<"wavefront rendering and further ao outputs trace their own rays, they need --ao-method rays"<<std::endl;
+		return false;
+	}
+
+	if(options.aaGrid <= 0 || options.aaGrid > 16 || options.blurSize <= 0 || options.blurSize > 31 || !(options.blurSize & 0x1))
+	{
+		std::cout<<"invalid antialiasing grid or blur size"<<std::endl;
+		return false;
+	}
+
+	// the progressive grid order is made for 5 x 5
+	if(options.aaGrid != 5 && options.progressive)
+	{
+		std::cout<<"progressive rendering uses the default antialiasing grid"<<std::endl;
+		return false;
+	}
+
+	if(options.budget <= 0)
+	{
+		std::cout<<"invalid time budget"<<std::endl;
+		return false;
+	}
+
+	if(options.tileSize <= 0)
+	{
+		std::cout<<"invalid tile size"<<std::endl;
+		return false;
+	}
+
+	if(options.tiled && options.output.empty())
+	{
+		std::cout<<"tiled rendering needs an output file"<<std::endl;
+		return false;
+	}
+
+	if(options.coordinatorPort < 0 || options.coordinatorPort > 65535)
+	{
+		std::cout<<"invalid port"<<std::endl;
+		return false;
+	}
+
+	if(options.coordinatorPort && options.output.empty())
+	{
+		std::cout<<"coordinator needs an output file"<<std::endl;
+		return false;
+	}
+
+	if(!options.animation.empty() && (!isFramePattern(options.output) || options.frames <= 0 || options.temporalStep < 0))
+	{
+		std::cout<<"animation needs an output pattern with one frame number like frame%03d.ppm(other % written as %%) and a positive frame count"<<std::endl;
+		return false;
+	}
+
+	if(!options.animation.empty() && (options.tiled || options.coordinatorPort))
+	{
+		std::cout<<"animations can not be rendered tiled or distributed"<<std::endl;
+		return false;
+	}
+
+	if(options.aoOutputs && (options.tiled || options.coordinatorPort || !options.worker.empty() || !options.animation.empty() || options.progressive || options.wavefront))
+	{
+		std::cout<<"further ao outputs are only computed for full frames without tiles, animation, progressive or wavefront rendering"<<std::endl;
+		return false;
+	}
+
+	if(options.aoScale != 1 && options.aoScale != 2 && options.aoScale != 4)
+	{
+		std::cout<<"invalid ao scale"<<std::endl;
+		return false;
+	}
+
+	if(options.aoScale > 1 && (options.tiled || options.coordinatorPort || !options.worker.empty() || !options.animation.empty() || options.progressive || options.aoOutputs || options.wavefront))
+	{
+		std::cout<<"reduced ao resolution is only supported for full frames without tiles, animation, progressive, wavefront or further ao outputs"<<std::endl;
+		return false;
+	}
+
+	// only the tile tasks of the pipelined renderer trace wavefronts
+	if(options.wavefront && (!options.pipeline || options.tiled || options.coordinatorPort || !options.worker.empty() || !options.animation.empty() ||
+		options.progressive || options.benchEdits || !options.server.empty()))
+	{
+		std::cout<<"wavefront rendering is only supported for pipelined full frames without tiles, distributed rendering, animation,"
+			<<" progressive rendering, edits or the server"<<std::endl;
+		return false;
+	}
+
+	if(!options.sharedFramebuffer.empty() && (options.tiled || options.coordinatorPort || !options.worker.empty() || !options.benchmark.empty()))
+	{
+		std::cout<<"the shared framebuffer needs full size images, it can not be used with tiles, distributed rendering or benchmarks"<<std::endl;
+		return false;
+	}
+
+	if(!options.server.empty() && (options.tiled || options.coordinatorPort || !options.worker.empty() || !options.benchmark.empty() ||
+		!options.animation.empty() || options.progressive || !options.sharedFramebuffer.empty()))
+	{
+		std::cout<<"the render server renders full frames, it can not be combined with tiles, distributed rendering,"
+			<<" benchmarks, animations, progressive rendering or a shared framebuffer"<<std::endl;
+		return false;
+	}
+
+	if(options.benchEdits < 0 || (options.benchEdits && (options.tiled || options.coordinatorPort || !options.worker.empty() ||
+		!options.benchmark.empty() || !options.animation.empty() || options.progressive || !options.server.empty())))
+	{
+		std::cout<<"edits are rendered into the full size images, they can not be combined with tiles, distributed rendering,"
+			<<" benchmarks, animations, progressive rendering or the server"<<std::endl;
+		return false;
+	}
+
+	if(!options.heatmap.empty() && (options.tiled || options.coordinatorPort || !options.worker.empty() || !options.benchmark.empty() ||
+		!options.animation.empty() || options.progressive || !options.server.empty() || options.benchEdits))
+	{
+		std::cout<<"heatmaps are recorded for a single full frame, they can not be combined with tiles, distributed rendering,"
+			<<" benchmarks, animations, progressive rendering, the server or edits"<<std::endl;
+		return false;
+	}
+
+	if(!options.trace.empty() && (!options.benchmark.empty() || options.benchNuma))
+	{
+		std::cout<<"benchmarks can not be traced"<<std::endl;
+		return false;
+	}
+
+	if(!options.decode.empty() && (options.output.empty() || (options.output.size() >= 5 &&
+		options.output.compare(options.output.size() - 5, 5, ".osat") == 0)))
+	{
+		std::cout<<"decoding needs a PPM output file"<<std::endl;
+		return false;
+	}
+
+	if(!options.temporalStep)options.temporalStep = std::max(1, options.aoSamples / 4);
+
+	// benchmark defaults
+	if(options.benchTypes.empty())options.benchTypes.push_back("sphere");
+	if(options.benchObjects.empty())
+	{
+		options.benchObjects.push_back(10);
+		options.benchObjects.push_back(100);
+		options.benchObjects.push_back(1000);
+	}
+	if(options.benchSizes.empty())
+	{
+		options.benchSizes.push_back(64);
+		options.benchSizes.push_back(128);
+	}
+	if(options.benchSamples.empty())
+	{
+		options.benchSamples.push_back(16);
+		options.benchSamples.push_back(64);
+	}
+	if(options.benchThreads.empty())
+	{
+		options.benchThreads.push_back(1);
+		options.benchThreads.push_back(2);
+		options.benchThreads.push_back(4);
+	}
+
+	return true;
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,89 @@
+// Object Space Ambient Occlusion Demo Project
+// (c) 2013 by L.Spiegelberg
+// This code may be redistributed or modified for any learning or teaching purposes
+// but not for any commercial uses
+// to gain further license informations please contact me via
+// spiegelb (at) in.tum.de
+
+#include <sstream>
+
+#include "Parallel.h"
+#include "Numa.h"
+#include "Trace.h"
+
+ThreadPool *ThreadPool::pool = NULL;
+boost::once_flag ThreadPool::flag = BOOST_ONCE_INIT;
+
+void ThreadPool::worker(const int index, unsigned int seen)
+{
+	std::ostringstream name;
+	name<<"pool "<<index;
+	setTraceThreadName(name.str());
+
+	boost::mutex::scoped_lock lock(mutex);
+
+	// core the thread is bound to
+	int pinned = -1;
+
+	while(true)
+	{
+		while(generation == seen)start.wait(lock);
+		seen = generation;
+
+		// job needs fewer threads
+		if(index >= jobThreads)continue;
+
+		int cpu = index < (int)affinity.size() ? affinity[index] : -1;
+
+		lock.unlock();
+
+		if(cpu != pinned && cpu >= 0 && pinThread(cpu))pinned = cpu;
+
+		job(index);
+		lock.lock();
+
+		if(--pending == 0)finished.notify_all();
+	}
+}
+
+void ThreadPool::run(const int numThreads, const boost::function<void (int)>& func)
+{
+	boost::mutex::scoped_lock lock(mutex);
+
+	// nested or concurrent job, use own threads
+	if(busy)
+	{
+		lock.unlock();
+
+		boost::thread_group own;
+		for(int i = 0; i < numThreads; i++)own.create_thread(boost::bind(func, i));
+		own.join_all();
+
+		return;
+	}
+
+	busy = true;
+
+	// new threads wait for the next generation
+	for(; size < numThreads; size++)
+		threads.create_thread(boost::bind(&ThreadPool::worker, this, size, generation));
+
+	job = func;
+	jobThreads = numThreads;
+	pending = numThreads;
+	generation++;
+
+	start.notify_all();
+
+	while(pending > 0)finished.wait(lock);
+
+	job.clear();
+	busy = false;
+}
+
+void ThreadPool::setAffinity(const std::vector<int>& cpus)
+{
+	boost::mutex::scoped_lock lock(mutex);
+
+	affinity = cpus;
+}
\ No newline at end of file
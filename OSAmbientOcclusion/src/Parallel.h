@@ -0,0 +1,119 @@
+// Object Space Ambient Occlusion Demo Project
+// (c) 2013 by L.Spiegelberg
+// This code may be redistributed or modified for any learning or teaching purposes
+// but not for any commercial uses
+// to gain further license informations please contact me via
+// spiegelb (at) in.tum.de
+
+#ifndef PARALLEL_HEADER_
+#define PARALLEL_HEADER_
+
+#include <vector>
+#include <boost/thread.hpp>
+#include <boost/function.hpp>
+#include <boost/bind.hpp>
+
+/// threads kept alive between parallel loops and task graphs, so the passes of a frame do not start
+/// new threads. a job issued while the pool is busy(from a pool thread or another render) gets own threads
+class ThreadPool
+{
+private:
+	boost::mutex				mutex;
+	boost::condition_variable	start;
+	boost::condition_variable	finished;
+	boost::thread_group			threads;
+	int							size;
+
+	/// current job, called with the number of the thread
+	boost::function<void (int)>	job;
+	int							jobThreads;
+
+	/// incremented for every job, threads wait for a change
+	unsigned int				generation;
+
+	/// threads of the current job still running
+	int							pending;
+	bool						busy;
+
+	/// core each thread is pinned to, empty if threads may run anywhere
+	std::vector<int>			affinity;
+
+	static ThreadPool			*pool;
+	static boost::once_flag		flag;
+
+	static void create()	{pool = new ThreadPool();}
+
+	ThreadPool():size(0), jobThreads(0), generation(0), pending(0), busy(false)	{}
+
+	void worker(const int index, unsigned int seen);
+
+public:
+	/// pool of the process, it is never destroyed
+	static ThreadPool& instance()
+	{
+		boost::call_once(&ThreadPool::create, flag);
+		return *pool;
+	}
+
+	/// call func(thread) on numThreads threads and wait for all of them
+	void run(const int numThreads, const boost::function<void (int)>& func);
+
+	/// pin thread i to core cpus[i], the threads bind themselves when they start their next job.
+	/// threads of nested jobs(see run) are not pinned
+	void setAffinity(const std::vector<int>& cpus);
+
+	/// threads started so far
+	int getSize()	{boost::mutex::scoped_lock lock(mutex); return size;}
+};
+
+/// hands out indices of a loop to several threads
+class ParallelLoop
+{
+private:
+	boost::mutex	mutex;
+	int				next;
+	int				count;
+
+	/// loop body, called with index and number of the thread
+	boost::function<void (int, int)> func;
+
+	void work(const int thread)
+	{
+		while(true)
+		{
+			mutex.lock();
+			int index = next++;
+			mutex.unlock();
+
+			if(index >= count)return;
+
+			func(index, thread);
+		}
+	}
+
+public:
+	ParallelLoop(const int _count, const boost::function<void (int, int)>& _func):next(0), count(_count), func(_func)	{}
+
+	void run(const int numThreads)
+	{
+		// no need for threads
+		if(numThreads <= 1)
+		{
+			for(int i = 0; i < count; i++)func(i, 0);
+			return;
+		}
+
+		ThreadPool::instance().run(numThreads, boost::bind(&ParallelLoop::work, this, _1));
+	}
+};
+
+/// calls func(index, thread) for all indices in [0, count) using numThreads threads,
+/// indices are handed out one by one so threads stay busy if items differ in cost
+inline void parallelFor(const int count, const int numThreads, const boost::function<void (int, int)>& func)
+{
+	ParallelLoop loop(count, func);
+
+	loop.run(numThreads);
+}
+
+#endif
\ No newline at end of file
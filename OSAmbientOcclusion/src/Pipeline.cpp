@@ -0,0 +1,358 @@
+// Object Space Ambient Occlusion Demo Project
+// (c) 2013 by L.Spiegelberg
+// This code may be redistributed or modified for any learning or teaching purposes
+// but not for any commercial uses
+// to gain further license informations please contact me via
+// spiegelb (at) in.tum.de
+
+#include <set>
+
+#include "main.h"
+#include "Pipeline.h"
+#include "TaskGraph.h"
+#include "Wavefront.h"
+#include "ScaledAO.h"
+#include "Numa.h"
+
+using namespace std;
+
+/// tasks of all tiles of a frame, kept for further frames of the same size
+class PipelinedRender
+{
+private:
+	/// temporaries of the tile tasks, one per thread and kept over frames
+	struct Scratch
+	{
+		vector<Color>		colors;
+		vector<Color>		normals;
+		vector<Color>		ao;
+		vector<AOSample>	samples;
+		vector<Vector>		points;
+		vector<Vector>		pointNormals;
+		vector<float>		occlusion;
+		vector<float>		column;
+		ScaledAO			scaled;
+		WavefrontBuffers	wavefront;
+	};
+
+	vector<Tile>	tiles;
+	int				tilesX;
+
+	TaskGraph		graph;
+	vector<Scratch>	scratch;
+
+	/// settings the graph was built for
+	int				width;
+	int				height;
+	int				tileSize;
+	int				threads;
+	int				blurSize;
+	bool			numa;
+
+	/// receives composited tiles, may be NULL
+	ITileOutput		*output;
+	boost::mutex	output_mutex;
+
+	void raytraceTile(const int index, const int thread)
+	{
+		STATS_TIMER(PASS_RAYTRACE);
+		TRACE_SCOPE_ARG("raytrace tile", "raytrace", index);
+
+		const Tile& tile = tiles[index];
+
+		vector<Color>& colors = scratch[thread].colors;
+		vector<Color>& normals = scratch[thread].normals;
+		colors.resize(tile.width * tile.height);
+		normals.resize(tile.width * tile.height);
+
+		for(int y = 0; y < tile.height; y++)
+			for(int x = 0; x < tile.width; x++)
+			{
+				int px = tile.x + x;
+				int py = tile.y + y;
+
+				CostProbe probe = g_costMap.probe();
+
+				// trace ray
+				Ray ray = g_camera.getRay(px, py);
+				Vector normal;
+
+				STATS_ADD(primaryRays, 1);
+				STATS_ADD(pixels, 1);
+
+				// store in buffer, tiles do not overlap
+				traceGBuffer(g_GBuffer, px, py, ray, normal);
+
+				colors[x + y * tile.width] = traceGrid(px, py, g_options.aaGrid);
+				normals[x + y * tile.width] = Color((normal.x + 1.0f) / 2.0f, (normal.y + 1.0f) / 2.0f, (normal.z + 1.0f) / 2.0f);
+
+				g_costMap.add(px, py, probe);
+			}
+
+		traceLock(norm_mutex, "norm_mutex");
+		for(int y = 0; y < tile.height; y++)
+			for(int x = 0; x < tile.width; x++)g_normals.setPixel(tile.x + x, tile.y + y, normals[x + y * tile.width]);
+		norm_mutex.unlock();
+
+		traceLock(img_mutex, "img_mutex");
+		for(int y = 0; y < tile.height; y++)
+			for(int x = 0; x < tile.width; x++)g_image.setPixel(tile.x + x, tile.y + y, colors[x + y * tile.width]);
+		img_mutex.unlock();
+	}
+
+	void depth(const int /*thread*/)
+	{
+		STATS_TIMER(PASS_RAYTRACE);
+
+		DepthPass();
+	}
+
+	/// ambient occlusion of the GBuffer points, same as traceAO without tracing the camera ray again
+	void ambientOcclusionTile(const int index, const int thread)
+	{
+		STATS_TIMER(PASS_AO);
+		TRACE_SCOPE_ARG("ao tile", "ao", index);
+
+		const Tile& tile = tiles[index];
+
+		Scratch& temp = scratch[thread];
+		vector<Vector>& points = temp.points;
+		vector<Vector>& normals = temp.pointNormals;
+
+		// occlusion, bent normals and obscurance from the same rays
+		if(g_options.aoOutputs)
+		{
+			vector<AOSample>& samples = temp.samples;
+			samples.assign(tile.width * tile.height, AOSample());
+			g_GBuffer.getTile(tile, points, normals);
+
+			STATS_ADD(primaryRays, tile.width * tile.height);
+
+			for(unsigned int i = 0; i < samples.size(); i++)
+			{
+				CostProbe probe = g_costMap.probe();
+
+				if(normals[i] * normals[i] > 0.0f)samples[i] = computeAOSample(points[i], normals[i], g_options.aoSamples);
+
+				g_costMap.add(tile.x + i % tile.width, tile.y + i / tile.width, probe);
+			}
+
+			traceLock(ao_mutex, "ao_mutex");
+			traceLock(aoext_mutex, "aoext_mutex");
+			for(int y = 0; y < tile.height; y++)
+				for(int x = 0; x < tile.width; x++)setAOPixel(tile.x + x, tile.y + y, samples[x + y * tile.width]);
+			aoext_mutex.unlock();
+			ao_mutex.unlock();
+
+			return;
+		}
+
+		vector<Color>& ao = temp.ao;
+		ao.resize(tile.width * tile.height);
+
+		// cost of the whole tile for the modes working on all its pixels at once
+		CostProbe probe = g_costMap.probe();
+
+		if(g_options.aoScale > 1)
+		{
+			// blocks of the tile only, the blur hides the seams at tile borders
+			ScaledAO& scaled = temp.scaled;
+			vector<float>& column = temp.column;
+			scaled.setup(g_GBuffer, tile, g_options.aoScale);
+
+			for(int bx = 0; bx < scaled.getBlocksX(); bx++)scaled.computeColumn(bx, thread);
+
+			for(int x = 0; x < tile.width; x++)
+			{
+				scaled.upsampleColumn(x, column);
+				for(int y = 0; y < tile.height; y++)ao[x + y * tile.width] = Color(column[y], column[y], column[y]);
+			}
+
+			STATS_ADD(primaryRays, tile.width * tile.height);
+
+			g_costMap.addTile(tile, probe);
+		}
+		else if(g_options.wavefront)
+		{
+			// rays of the whole tile are sorted and traced together
+			vector<float>& occlusion = temp.occlusion;
+			g_GBuffer.getTile(tile, points, normals);
+
+			STATS_ADD(primaryRays, tile.width * tile.height);
+
+			wavefrontAO(points, normals, g_options.aoSamples, occlusion, temp.wavefront);
+
+			for(unsigned int i = 0; i < ao.size(); i++)ao[i] = Color(occlusion[i], occlusion[i], occlusion[i]);
+
+			g_costMap.addTile(tile, probe);
+		}
+		else
+		{
+			g_GBuffer.getTile(tile, points, normals);
+
+			STATS_ADD(primaryRays, tile.width * tile.height);
+
+			for(unsigned int i = 0; i < ao.size(); i++)
+			{
+				probe = g_costMap.probe();
+
+				float occlusion = 0.0f;
+				if(normals[i] * normals[i] > 0.0f)occlusion = computeAO(points[i], normals[i], g_options.aoSamples);
+
+				ao[i] = Color(occlusion, occlusion, occlusion);
+
+				g_costMap.add(tile.x + i % tile.width, tile.y + i / tile.width, probe);
+			}
+		}
+
+		traceLock(ao_mutex, "ao_mutex");
+		for(int y = 0; y < tile.height; y++)
+			for(int x = 0; x < tile.width; x++)g_aopass.setPixel(tile.x + x, tile.y + y, ao[x + y * tile.width]);
+		ao_mutex.unlock();
+	}
+
+	void blurTile(const int index, const int /*thread*/)
+	{
+		STATS_TIMER(PASS_BLUR);
+		TRACE_SCOPE_ARG("blur tile", "blur", index);
+
+		const Tile& tile = tiles[index];
+
+		// g_aopass is complete around the tile, periodic boundaries like Image::blur
+		traceLock(ao_mutex, "ao_mutex");
+		traceLock(invao_mutex, "invao_mutex");
+
+		g_invao.blurFrom(g_aopass, tile.x, tile.y, tile.x, tile.y, tile.width, tile.height);
+
+		for(int y = tile.y; y < tile.y + tile.height; y++)
+			for(int x = tile.x; x < tile.x + tile.width; x++)g_invao.setPixel(x, y, Color(1.0f, 1.0f, 1.0f) - g_invao.getPixel(x, y));
+
+		invao_mutex.unlock();
+		ao_mutex.unlock();
+	}
+
+	void compositeTile(const int index, const int /*thread*/)
+	{
+		STATS_TIMER(PASS_COMPOSITE);
+		TRACE_SCOPE_ARG("composite tile", "composite", index);
+
+		const Tile& tile = tiles[index];
+
+		traceLock(img_mutex, "img_mutex");
+		traceLock(invao_mutex, "invao_mutex");
+		traceLock(final_mutex, "final_mutex");
+		g_sharedFramebuffer.beginTile(tile);
+
+		for(int y = tile.y; y < tile.y + tile.height; y++)
+			for(int x = tile.x; x < tile.x + tile.width; x++)g_final.setPixel(x, y, g_image.getPixel(x, y) * g_invao.getPixel(x, y));
+
+		g_sharedFramebuffer.publishTile(tile);
+		final_mutex.unlock();
+		invao_mutex.unlock();
+		img_mutex.unlock();
+
+		if(output)
+		{
+			// tile data has to start at(0, 0)
+			Image final(tile.width, tile.height);
+
+			traceLock(final_mutex, "final_mutex");
+			for(int y = 0; y < tile.height; y++)
+				for(int x = 0; x < tile.width; x++)final.setPixel(x, y, g_final.getPixel(tile.x + x, tile.y + y));
+			final_mutex.unlock();
+
+			traceLock(output_mutex, "output_mutex");
+			output->writeTile(tile, final);
+			output_mutex.unlock();
+		}
+	}
+
+	/// tasks of all tiles and their dependencies for the current settings
+	void build()
+	{
+		width = g_width;
+		height = g_height;
+		tileSize = g_options.tileSize;
+		threads = g_options.threads;
+		blurSize = Image::blurSize();
+		numa = g_options.numa;
+
+		tiles = generateTiles(g_width, g_height, g_options.tileSize);
+		tilesX = (g_width + g_options.tileSize - 1) / g_options.tileSize;
+
+		scratch.resize(max(g_options.threads, 1));
+
+		graph.clear();
+
+		int count = (int)tiles.size();
+		vector<int> raytrace(count), ao(count), blur(count), composite(count);
+
+		for(int i = 0; i < count; i++)
+		{
+			// with --numa all passes of a tile run on the thread that placed its memory(see createImages)
+			int owner = g_options.numa ? blockOwner(i, count, g_options.threads) : -1;
+
+			raytrace[i] = graph.add(boost::bind(&PipelinedRender::raytraceTile, this, i, _1), owner);
+			ao[i] = graph.add(boost::bind(&PipelinedRender::ambientOcclusionTile, this, i, _1), owner);
+			blur[i] = graph.add(boost::bind(&PipelinedRender::blurTile, this, i, _1), owner);
+			composite[i] = graph.add(boost::bind(&PipelinedRender::compositeTile, this, i, _1), owner);
+
+			graph.depend(ao[i], raytrace[i]);
+			graph.depend(composite[i], blur[i]);
+		}
+
+		// depth image needs the range of the whole GBuffer
+		int depthTask = graph.add(boost::bind(&PipelinedRender::depth, this, _1));
+		for(int i = 0; i < count; i++)graph.depend(depthTask, raytrace[i]);
+
+		// blur reads ambient occlusion within its radius around the tile, wrapped around the image
+		const int border = Image::blurSize() / 2;
+
+		for(int i = 0; i < count; i++)
+		{
+			const Tile& tile = tiles[i];
+
+			// tile columns and rows touched by the blur kernel
+			set<int> columns, rows;
+
+			for(int x = tile.x - border; x < tile.x + tile.width + border; x++)columns.insert(((x % g_width + g_width) % g_width) / g_options.tileSize);
+			for(int y = tile.y - border; y < tile.y + tile.height + border; y++)rows.insert(((y % g_height + g_height) % g_height) / g_options.tileSize);
+
+			set<int> halo;
+			for(set<int>::iterator r = rows.begin(); r != rows.end(); ++r)
+				for(set<int>::iterator c = columns.begin(); c != columns.end(); ++c)halo.insert(*c + *r * tilesX);
+
+			for(set<int>::iterator it = halo.begin(); it != halo.end(); ++it)graph.depend(blur[i], ao[*it]);
+		}
+	}
+
+public:
+	PipelinedRender():tilesX(0), width(0), height(0), tileSize(0), threads(0), blurSize(0), numa(false), output(NULL)	{}
+
+	/// render a frame, the graph is only built again if the image size or the settings it depends on changed
+	void run(ITileOutput *_output)
+	{
+		if(width != g_width || height != g_height || tileSize != g_options.tileSize || threads != g_options.threads ||
+			blurSize != Image::blurSize() || numa != g_options.numa)build();
+
+		output = _output;
+
+		graph.run(g_options.threads);
+
+		output = NULL;
+	}
+};
+
+static PipelinedRender g_pipelinedRender;
+
+void RenderPipelined(ITileOutput *output)
+{
+	STATS_TIMER(PASS_FRAME);
+	TRACE_SCOPE("frame", "frame");
+
+	g_GBuffer.setCamera(g_camera, 0, 0);
+
+	g_pipelinedRender.run(output);
+
+	g_sharedFramebuffer.publishFrame(g_GBuffer);
+}
\ No newline at end of file
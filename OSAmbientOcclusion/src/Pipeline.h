@@ -0,0 +1,22 @@
+// Object Space Ambient Occlusion Demo Project
+// (c) 2013 by L.Spiegelberg
+// This code may be redistributed or modified for any learning or teaching purposes
+// but not for any commercial uses
+// to gain further license informations please contact me via
+// spiegelb (at) in.tum.de
+
+#ifndef PIPELINE_HEADER_
+#define PIPELINE_HEADER_
+
+#include "TileOutput.h"
+
+// the pipelined renderer splits the full size images into tiles and runs the passes of each tile
+// as tasks of a TaskGraph: raytrace -> ambient occlusion -> blur -> composite. the blur of a tile
+// also waits for the ambient occlusion of all tiles within the blur radius(wrapping around the image
+// like Image::blur), so passes of different tiles overlap and no thread waits for a whole pass
+
+/// render all passes of the full size images with a graph of tile tasks,
+/// composited tiles are also passed to output if given(begin and end are left to the caller)
+void RenderPipelined(ITileOutput *output = NULL);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,94 @@
+// Object Space Ambient Occlusion Demo Project
+// (c) 2013 by L.Spiegelberg
+// This code may be redistributed or modified for any learning or teaching purposes
+// but not for any commercial uses
+// to gain further license informations please contact me via
+// spiegelb (at) in.tum.de
+
+#ifndef POOL_HEADER_
+#define POOL_HEADER_
+
+#include <vector>
+#include <utility>
+#include <boost/thread.hpp>
+
+/// keeps released arrays for reuse, so buffers created again with the same size in later passes
+/// or frames do not touch the heap. one pool per element type, shared by all threads.
+/// elements are neither constructed nor destroyed, T has to be a plain type like Color or float
+template<class T> class ArrayPool
+{
+private:
+	boost::mutex							mutex;
+
+	/// released arrays and their sizes
+	std::vector<std::pair<int, T*> >		arrays;
+
+	static ArrayPool						*pool;
+	static boost::once_flag					flag;
+
+	static void create()	{pool = new ArrayPool();}
+
+	ArrayPool()	{arrays.reserve(max_arrays);}
+
+public:
+	/// released arrays beyond this are deleted
+	static const int max_arrays = 64;
+
+	/// pool of the element type. it is never destroyed, global buffers may be released after main returned
+	static ArrayPool& instance()
+	{
+		boost::call_once(&ArrayPool::create, flag);
+		return *pool;
+	}
+
+	/// array of count elements, contents are undefined if it was used before
+	T *acquire(const int count)
+	{
+		mutex.lock();
+		for(unsigned int i = 0; i < arrays.size(); i++)
+			if(arrays[i].first == count)
+			{
+				T *res = arrays[i].second;
+				arrays[i] = arrays.back();
+				arrays.pop_back();
+
+				mutex.unlock();
+				return res;
+			}
+		mutex.unlock();
+
+		// elements are not constructed, so the pages of a new array are placed on the NUMA node
+		// of the thread that writes them first instead of the one allocating them
+		return static_cast<T*>(::operator new(sizeof(T) * count));
+	}
+
+	/// give array back for reuse, NULL is ignored
+	void release(T *array, const int count)
+	{
+		if(!array)return;
+
+		mutex.lock();
+		if((int)arrays.size() < max_arrays)
+		{
+			arrays.push_back(std::make_pair(count, array));
+			array = NULL;
+		}
+		mutex.unlock();
+
+		::operator delete(array);
+	}
+
+	/// delete all released arrays, e.g. after the image size changed
+	void clear()
+	{
+		mutex.lock();
+		for(unsigned int i = 0; i < arrays.size(); i++)::operator delete(arrays[i].second);
+		arrays.clear();
+		mutex.unlock();
+	}
+};
+
+template<class T> ArrayPool<T> *ArrayPool<T>::pool = NULL;
+template<class T> boost::once_flag ArrayPool<T>::flag = BOOST_ONCE_INIT;
+
+#endif
\ No newline at end of file
@@ -0,0 +1,228 @@
+// Object Space Ambient Occlusion Demo Project
+// (c) 2013 by L.Spiegelberg
+// This code may be redistributed or modified for any learning or teaching purposes
+// but not for any commercial uses
+// to gain further license informations please contact me via
+// spiegelb (at) in.tum.de
+
+#include "main.h"
+#include "Progressive.h"
+
+using namespace std;
+
+// the preview traces one ray per block of pixels
+static const int preview_block = 4;
+
+// antialiasing uses the 5x5 grid of traceGrid, so the converged image is the same.
+// stepping through the grid with stride 7 starts in the center and spreads the first samples
+static const int aa_grid = 5;
+static const int aa_samples = aa_grid * aa_grid;
+
+static inline int aaSample(const int round)
+{
+	return (12 + round * 7) % aa_samples;
+}
+
+class ProgressiveRender
+{
+private:
+	// accumulation buffers
+	vector<Color>	colorSum;
+	vector<int>		colorCount;
+	vector<float>	aoSum;
+	vector<int>		aoCount;
+
+	/// ambient occlusion samples added per round
+	int		aoStep;
+
+	/// current refinement round and first column of the current chunk
+	int		round;
+	int		chunkStart;
+
+	Timer	timer;
+	double	lastPublish;
+
+	/// time the last publish took
+	double	publishTime;
+
+	/// one ray per block, written directly to the images
+	void previewColumn(const int bx, const int /*thread*/)
+	{
+		int x0 = bx * preview_block;
+		int cx = min(x0 + preview_block / 2, g_width - 1);
+
+		for(int y0 = 0; y0 < g_height; y0 += preview_block)
+		{
+			int cy = min(y0 + preview_block / 2, g_height - 1);
+
+			Vector normal;
+			Vector point;
+
+			STATS_ADD(primaryRays, 1);
+			Color col = traceRay(g_camera.getRay(cx, cy), normal, point);
+			float ao = normal * normal > 0.0f ? computeAO(point, normal, aoStep) : 0.0f;
+
+			int x1 = min(x0 + preview_block, g_width);
+			int y1 = min(y0 + preview_block, g_height);
+
+			traceLock(img_mutex, "img_mutex");
+			for(int x = x0; x < x1; x++)
+				for(int y = y0; y < y1; y++)g_image.setPixel(x, y, col);
+			img_mutex.unlock();
+
+			traceLock(ao_mutex, "ao_mutex");
+			for(int x = x0; x < x1; x++)
+				for(int y = y0; y < y1; y++)g_aopass.setPixel(x, y, Color(ao, ao, ao));
+			ao_mutex.unlock();
+		}
+	}
+
+	/// add the samples of the current round to a column
+	void refineColumn(const int column, const int /*thread*/)
+	{
+		int x = chunkStart + column;
+
+		for(int y = 0; y < g_height; y++)
+		{
+			int index = x + y * g_width;
+
+			// first round fills the GBuffer
+			if(round == 0)
+			{
+				Vector normal;
+
+				STATS_ADD(primaryRays, 1);
+				STATS_ADD(pixels, 1);
+
+				traceGBuffer(g_GBuffer, x, y, g_camera.getRay(x, y), normal);
+			}
+
+			// antialiasing
+			if(colorCount[index] < aa_samples)
+			{
+				int s = aaSample(colorCount[index]);
+				float fdX = 1.0f / (float)aa_grid;
+
+				Vector normal;
+				Vector point;
+				Ray ray = g_camera.getRay((float)x - 0.5f + fdX * (s / aa_grid), (float)y - 0.5f + fdX * (s % aa_grid));
+
+				STATS_ADD(aaRays, 1);
+				colorSum[index] = colorSum[index] + traceRay(ray, normal, point);
+				colorCount[index]++;
+			}
+
+			// ambient occlusion
+			if(aoCount[index] < g_options.aoSamples)
+			{
+				int n = min(aoStep, g_options.aoSamples - aoCount[index]);
+
+				Vector normal = g_GBuffer.getNormal(x, y);
+				if(normal * normal > 0.0f)aoSum[index] += computeAO(g_GBuffer.getPoint(x, y), normal, n) * (float)n;
+				aoCount[index] += n;
+			}
+		}
+	}
+
+	/// show accumulated state, pixels not traced yet keep the preview
+	void publish()
+	{
+		double start = timer.elapsed();
+
+		traceLock(img_mutex, "img_mutex");
+		for(int y = 0; y < g_height; y++)
+			for(int x = 0; x < g_width; x++)
+			{
+				int index = x + y * g_width;
+				if(colorCount[index])g_image.setPixel(x, y, colorSum[index] / (float)colorCount[index]);
+			}
+		img_mutex.unlock();
+
+		traceLock(ao_mutex, "ao_mutex");
+		for(int y = 0; y < g_height; y++)
+			for(int x = 0; x < g_width; x++)
+			{
+				int index = x + y * g_width;
+				if(aoCount[index])
+				{
+					float ao = aoSum[index] / (float)aoCount[index];
+					g_aopass.setPixel(x, y, Color(ao, ao, ao));
+				}
+			}
+		ao_mutex.unlock();
+
+		CompositePass();
+
+		lastPublish = timer.elapsed();
+		publishTime = lastPublish - start;
+	}
+
+public:
+	ProgressiveRender():aoStep(1), round(0), chunkStart(0), lastPublish(0.0), publishTime(0.0)	{}
+
+	void run()
+	{
+		int size = g_width * g_height;
+
+		colorSum.assign(size, Color::black);
+		colorCount.assign(size, 0);
+		aoSum.assign(size, 0.0f);
+		aoCount.assign(size, 0);
+
+		aoStep = max(1, g_options.aoSamples / 16);
+
+		double budget = (double)g_options.budget / 1000.0;
+
+		timer.restart();
+
+		// coarse preview
+		parallelFor((g_width + preview_block - 1) / preview_block, g_options.threads,
+			boost::bind(&ProgressiveRender::previewColumn, this, _1, _2));
+		CompositePass();
+
+		double previewTime = timer.elapsed();
+		double fullTime = 0.0;
+
+		// refine round by round, columns are handed out in chunks so the image can be published in between
+		int rounds = max(aa_samples, (g_options.aoSamples + aoStep - 1) / aoStep);
+		int chunk = max(1, g_options.threads * 8);
+
+		for(round = 0; round < rounds; round++)
+		{
+			for(chunkStart = 0; chunkStart < g_width; chunkStart += chunk)
+			{
+				parallelFor(min(chunk, g_width - chunkStart), g_options.threads,
+					boost::bind(&ProgressiveRender::refineColumn, this, _1, _2));
+
+				// publishing must not take more than a fifth of the time
+				if(timer.elapsed() - lastPublish >= max(budget, 4.0 * publishTime))publish();
+			}
+
+			if(round == 0)
+			{
+				publish();
+				fullTime = timer.elapsed();
+			}
+		}
+
+		publish();
+
+		// depth image of the complete GBuffer
+		DepthPass();
+
+		cout<<"progressive: preview after "<<previewTime * 1000.0<<" ms, full resolution after "<<fullTime * 1000.0
+			<<" ms, converged after "<<timer.elapsed() * 1000.0<<" ms"<<endl;
+	}
+};
+
+void RenderProgressive()
+{
+	STATS_TIMER(PASS_FRAME);
+	TRACE_SCOPE("frame", "frame");
+
+	g_GBuffer.setCamera(g_camera, 0, 0);
+
+	ProgressiveRender render;
+
+	render.run();
+}
\ No newline at end of file
@@ -0,0 +1,19 @@
+// Object Space Ambient Occlusion Demo Project
+// (c) 2013 by L.Spiegelberg
+// This code may be redistributed or modified for any learning or teaching purposes
+// but not for any commercial uses
+// to gain further license informations please contact me via
+// spiegelb (at) in.tum.de
+
+#ifndef PROGRESSIVE_HEADER_
+#define PROGRESSIVE_HEADER_
+
+// progressive rendering shows a usable image as early as possible: a coarse preview with one
+// ray per block of pixels comes first, then every pixel is traced and antialiasing and ambient
+// occlusion samples are added round by round into accumulation buffers. every g_options.budget
+// milliseconds the accumulated state is published to the images shown by the viewer
+
+/// render the full size images progressively, ends when all pixels are converged
+void RenderProgressive();
+
+#endif
\ No newline at end of file
@@ -0,0 +1,47 @@
+// Object Space Ambient Occlusion Demo Project
+// (c) 2013 by L.Spiegelberg
+// This code may be redistributed or modified for any learning or teaching purposes
+// but not for any commercial uses
+// to gain further license informations please contact me via
+// spiegelb (at) in.tum.de
+
+#ifndef RANDOM_HEADER_
+#define RANDOM_HEADER_
+
+#include <cstdlib>
+
+#include "Stats.h"
+
+// every thread has its own random generator(xorshift), rand() would
+// serialize render threads on its lock
+
+/// state of the random generator of the calling thread, 0 = not seeded yet
+inline unsigned int& randomState()
+{
+	static OSAO_THREAD_LOCAL unsigned int state = 0;
+	return state;
+}
+
+/// seed random generator of the calling thread
+inline void seedRandom(const unsigned int seed)
+{
+	randomState() = seed ? seed : 0x9e3779b9;
+}
+
+/// float random function
+inline float random(float fmin, float fmax)
+{
+	unsigned int& s = randomState();
+
+	// threads which were not seeded explicitly are seeded from rand()
+	if(!s)seedRandom((unsigned int)rand() * 2654435761u + 1u);
+
+	s ^= s << 13;
+	s ^= s >> 17;
+	s ^= s << 5;
+
+	// use upper 24 bits, they fit exactly into a float
+	return fmin + ((float)(s >> 8) * (1.0f / 16777216.0f)) * (fmax - fmin);
+}
+
+#endif
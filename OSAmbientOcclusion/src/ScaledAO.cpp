@@ -0,0 +1,135 @@
+// Object Space Ambient Occlusion Demo Project
+// (c) 2013 by L.Spiegelberg
+// This code may be redistributed or modified for any learning or teaching purposes
+// but not for any commercial uses
+// to gain further license informations please contact me via
+// spiegelb (at) in.tum.de
+
+#include <cmath>
+
+#include "main.h"
+#include "ScaledAO.h"
+
+using namespace std;
+
+const float ScaledAO::normal_power = 8.0f;
+const float ScaledAO::plane_tolerance = 0.1f;
+const float ScaledAO::min_weight = 0.05f;
+
+ScaledAO::ScaledAO(GBuffer& _gbuffer, const Tile& _region, const int _scale)
+{
+	setup(_gbuffer, _region, _scale);
+}
+
+void ScaledAO::setup(GBuffer& _gbuffer, const Tile& _region, const int _scale)
+{
+	gbuffer = &_gbuffer;
+	region = _region;
+	scale = _scale;
+
+	blocksX = (region.width + scale - 1) / scale;
+	blocksY = (region.height + scale - 1) / scale;
+
+	points.resize(blocksX * blocksY);
+	normals.resize(blocksX * blocksY);
+	occlusion.assign(blocksX * blocksY, 0.0f);
+}
+
+void ScaledAO::chooseSample(const int bx, const int by)
+{
+	int index = bx + by * blocksX;
+	int best = -1;
+
+	normals[index] = Vector(0.0f, 0.0f, 0.0f);
+
+	// center of the block, twice as large to stay integer
+	int cx = 2 * bx * scale + scale - 1;
+	int cy = 2 * by * scale + scale - 1;
+
+	for(int y = by * scale; y < min((by + 1) * scale, region.height); y++)
+		for(int x = bx * scale; x < min((bx + 1) * scale, region.width); x++)
+		{
+			Vector normal = gbuffer->getNormal(region.x + x, region.y + y);
+			if(normal * normal == 0.0f)continue;
+
+			int distance = (2 * x - cx) * (2 * x - cx) + (2 * y - cy) * (2 * y - cy);
+			if(best >= 0 && distance >= best)continue;
+
+			best = distance;
+			points[index] = gbuffer->getPoint(region.x + x, region.y + y);
+			normals[index] = normal;
+		}
+}
+
+void ScaledAO::computeColumn(const int bx, const int /*thread*/)
+{
+	for(int by = 0; by < blocksY; by++)
+	{
+		chooseSample(bx, by);
+
+		int index = bx + by * blocksX;
+		if(normals[index] * normals[index] > 0.0f)occlusion[index] = computeAO(points[index], normals[index], g_options.aoSamples);
+	}
+}
+
+void ScaledAO::upsampleColumn(const int x, vector<float>& column)
+{
+	column.resize(region.height);
+
+	// the two block columns around the pixel center
+	float fx = ((float)x + 0.5f) / (float)scale - 0.5f;
+	int bx0 = (int)floor(fx);
+	float tx = fx - (float)bx0;
+
+	float sigma = plane_tolerance * g_options.aoRadius;
+
+	for(int y = 0; y < region.height; y++)
+	{
+		Vector point = gbuffer->getPoint(region.x + x, region.y + y);
+		Vector normal = gbuffer->getNormal(region.x + x, region.y + y);
+
+		column[y] = 0.0f;
+		if(normal * normal == 0.0f)continue;
+
+		float fy = ((float)y + 0.5f) / (float)scale - 0.5f;
+		int by0 = (int)floor(fy);
+		float ty = fy - (float)by0;
+
+		float sum = 0.0f;
+		float weights = 0.0f;
+
+		// best matching block, used if the pixel sits on the border of a surface
+		float bestMatch = 0.0f;
+		float bestOcclusion = 0.0f;
+
+		for(int j = 0; j < 2; j++)
+			for(int i = 0; i < 2; i++)
+			{
+				// blocks beyond the region are replaced by the border blocks
+				int bx = max(0, min(blocksX - 1, bx0 + i));
+				int by = max(0, min(blocksY - 1, by0 + j));
+				int index = bx + by * blocksX;
+
+				float cosine = normal * normals[index];
+				if(cosine <= 0.0f)continue;
+
+				float plane = (points[index] - point) * normal / sigma;
+
+				float match = pow(cosine, normal_power) * exp(-plane * plane);
+				float weight = (i ? tx : 1.0f - tx) * (j ? ty : 1.0f - ty) * match;
+
+				sum += weight * occlusion[index];
+				weights += weight;
+
+				if(match > bestMatch)
+				{
+					bestMatch = match;
+					bestOcclusion = occlusion[index];
+				}
+			}
+
+		// no block lies on the same surface
+		if(bestMatch < min_weight)column[y] = computeAO(point, normal, g_options.aoSamples);
+		else column[y] = weights > 0.0f ? sum / weights : bestOcclusion;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,63 @@
+// Object Space Ambient Occlusion Demo Project
+// (c) 2013 by L.Spiegelberg
+// This code may be redistributed or modified for any learning or teaching purposes
+// but not for any commercial uses
+// to gain further license informations please contact me via
+// spiegelb (at) in.tum.de
+
+#ifndef SCALEDAO_HEADER_
+#define SCALEDAO_HEADER_
+
+#include <vector>
+
+#include "GBuffer.h"
+#include "Tiles.h"
+
+/// ambient occlusion at a reduced resolution. one GBuffer sample per scale x scale block gets ambient
+/// occlusion, pixels blend the nearest blocks weighted by how well their normal and plane match. pixels
+/// without any matching block(e.g. thin objects smaller than a block) get their own ambient occlusion
+class ScaledAO
+{
+private:
+	GBuffer	*gbuffer;
+	Tile	region;
+	int		scale;
+	int		blocksX;
+	int		blocksY;
+
+	// representative sample of each block, normal is zero if no pixel of the block hit anything
+	std::vector<Vector>	points;
+	std::vector<Vector>	normals;
+	std::vector<float>	occlusion;
+
+	/// choose the hit pixel nearest to the center of the block
+	void chooseSample(const int bx, const int by);
+
+public:
+	/// weight of the normals, the cosine between them is raised to this power
+	static const float normal_power;
+
+	/// distance of a block sample to the plane of a pixel, relative to the ao radius, at which its weight drops to 1/e
+	static const float plane_tolerance;
+
+	/// pixels matching none of their blocks better than this compute their own ambient occlusion
+	static const float min_weight;
+
+	ScaledAO():gbuffer(NULL), scale(1), blocksX(0), blocksY(0)	{}
+
+	/// region of gbuffer in pixels, scale is the edge length of a block
+	ScaledAO(GBuffer& _gbuffer, const Tile& _region, const int _scale);
+
+	/// start over with another region, the block arrays are kept if they are large enough
+	void setup(GBuffer& _gbuffer, const Tile& _region, const int _scale);
+
+	inline int getBlocksX() const	{return blocksX;}
+
+	/// ambient occlusion of the block samples in column bx
+	void computeColumn(const int bx, const int thread);
+
+	/// upsampled ambient occlusion of column x of the region, needs all block columns to be computed
+	void upsampleColumn(const int x, std::vector<float>& column);
+};
+
+#endif
\ No newline at end of file
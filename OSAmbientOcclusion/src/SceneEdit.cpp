@@ -0,0 +1,400 @@
+// Object Space Ambient Occlusion Demo Project
+// (c) 2013 by L.Spiegelberg
+// This code may be redistributed or modified for any learning or teaching purposes
+// but not for any commercial uses
+// to gain further license informations please contact me via
+// spiegelb (at) in.tum.de
+
+#include <cfloat>
+
+#include "main.h"
+#include "SceneEdit.h"
+
+using namespace std;
+
+static inline float component(const Vector& v, const int axis)
+{
+	return axis == 0 ? v.x : (axis == 1 ? v.y : v.z);
+}
+
+/// distance at which r enters the box, false if it misses it
+static bool enterBox(const Ray& r, const Vector& bmin, const Vector& bmax, float& tEnter)
+{
+	float tmin = 0.0f;
+	float tmax = no_hit_distance;
+
+	for(int a = 0; a < 3; a++)
+	{
+		float o = component(r.origin, a);
+		float d = component(r.direction, a);
+
+		if(d == 0.0f)
+		{
+			if(o < component(bmin, a) || o > component(bmax, a))return false;
+			continue;
+		}
+
+		float t0 = (component(bmin, a) - o) / d;
+		float t1 = (component(bmax, a) - o) / d;
+		if(t0 > t1)swap(t0, t1);
+
+		tmin = max(tmin, t0);
+		tmax = min(tmax, t1);
+	}
+
+	tEnter = tmin;
+
+	return tmin <= tmax;
+}
+
+static inline bool insideBox(const Vector& p, const Vector& bmin, const Vector& bmax)
+{
+	return p.x >= bmin.x && p.y >= bmin.y && p.z >= bmin.z && p.x <= bmax.x && p.y <= bmax.y && p.z <= bmax.z;
+}
+
+void SceneEditor::touch(IObject *object)
+{
+	Vector omin, omax;
+	object->getBounds(omin, omax);
+
+	changedMin = changed ? VectorMin(changedMin, omin) : omin;
+	changedMax = changed ? VectorMax(changedMax, omax) : omax;
+	changed = true;
+}
+
+int SceneEditor::addObject(IObject *object)
+{
+	g_objects.push_back(object);
+	touch(object);
+
+	return (int)g_objects.size() - 1;
+}
+
+bool SceneEditor::removeObject(const int index)
+{
+	if(index < 0 || index >= (int)g_objects.size())return false;
+
+	touch(g_objects[index]);
+
+	delete g_objects[index];
+	g_objects.erase(g_objects.begin() + index);
+
+	// object indices of the other hits stay valid
+	g_GBuffer.removeObject(index);
+
+	return true;
+}
+
+bool SceneEditor::moveObject(const int index, const Vector& offset)
+{
+	if(index < 0 || index >= (int)g_objects.size())return false;
+
+	touch(g_objects[index]);
+	g_objects[index]->translate(offset);
+	touch(g_objects[index]);
+
+	return true;
+}
+
+/// farthest camera ray hit of the pixel and its eight neighbours, infinite if one of them hits nothing
+static float neighbourDepth(const int x, const int y)
+{
+	float depth = 0.0f;
+
+	for(int j = max(y - 1, 0); j <= min(y + 1, g_height - 1); j++)
+		for(int i = max(x - 1, 0); i <= min(x + 1, g_width - 1); i++)
+		{
+			if(g_GBuffer.getObject(i, j) == GBuffer::no_object)return FLT_MAX;
+			depth = max(depth, g_GBuffer.getDepth(i, j));
+		}
+
+	return depth;
+}
+
+void SceneEditor::markColumn(const int x, const int /*thread*/)
+{
+	for(int y = 0; y < g_height; y++)
+	{
+		// something in front of the old hit changed. antialiasing rays may pass the silhouette of the hit
+		// object, so the farthest hit of the neighbouring pixels is used
+		Ray ray = g_camera.getRay((float)x, (float)y);
+		float tEnter;
+
+		if(enterBox(ray, visibleMin, visibleMax, tEnter) && tEnter <= neighbourDepth(x, y))
+		{
+			mask[x + y * g_width] = 1;
+			continue;
+		}
+
+		// geometry within the reach of the ambient occlusion rays changed
+		if(g_GBuffer.getObject(x, y) != GBuffer::no_object && insideBox(g_GBuffer.getPoint(x, y), aoMin, aoMax))
+			mask[x + y * g_width] = 1;
+	}
+}
+
+void SceneEditor::renderColumn(const int x, const int thread)
+{
+	vector<Color>& column = columns[thread];
+	column.resize(g_height);
+
+	bool any = false;
+
+	for(int y = 0; y < g_height; y++)
+	{
+		if(!mask[x + y * g_width])continue;
+		any = true;
+
+		Ray ray = g_camera.getRay((float)x, (float)y);
+		Vector normal;
+
+		STATS_ADD(primaryRays, 1);
+		STATS_ADD(pixels, 1);
+
+		traceGBuffer(g_GBuffer, x, y, ray, normal);
+		column[y] = traceGrid(x, y, g_options.aaGrid);
+
+		// ambient occlusion at full resolution, also if the frame was rendered with --ao-scale
+		bool hit = g_GBuffer.getObject(x, y) != GBuffer::no_object;
+		Vector point = g_GBuffer.getPoint(x, y);
+
+		if(g_options.aoOutputs)
+		{
+			AOSample sample;
+			if(hit)sample = computeAOSample(point, g_GBuffer.getNormal(x, y), g_options.aoSamples);
+
+			traceLock(ao_mutex, "ao_mutex");
+			traceLock(aoext_mutex, "aoext_mutex");
+			setAOPixel(x, y, sample);
+			aoext_mutex.unlock();
+			ao_mutex.unlock();
+		}
+		else
+		{
+			float occlusion = hit ? computeAO(point, g_GBuffer.getNormal(x, y), g_options.aoSamples) : 0.0f;
+
+			traceLock(ao_mutex, "ao_mutex");
+			g_aopass.setPixel(x, y, Color(occlusion, occlusion, occlusion));
+			ao_mutex.unlock();
+		}
+	}
+
+	if(!any)return;
+
+	traceLock(img_mutex, "img_mutex");
+	for(int y = 0; y < g_height; y++)
+		if(mask[x + y * g_width])g_image.setPixel(x, y, column[y]);
+	img_mutex.unlock();
+}
+
+int SceneEditor::update(ITileOutput *output)
+{
+	if(!changed)return 0;
+	changed = false;
+
+	STATS_TIMER(PASS_FRAME);
+	TRACE_SCOPE("edit", "frame");
+
+	buildAccelerators();
+
+	// antialiasing rays of a pixel spread by about the distance of neighbouring camera rays,
+	// which is largest in the image center
+	Ray center = g_camera.getRay((float)(g_width / 2), (float)(g_height / 2));
+	float spacing = max(VectorLength(g_camera.getRay((float)(g_width / 2 + 1), (float)(g_height / 2)).direction - center.direction),
+		VectorLength(g_camera.getRay((float)(g_width / 2), (float)(g_height / 2 + 1)).direction - center.direction));
+
+	float farthest = 0.0f;
+	for(int i = 0; i < 8; i++)
+	{
+		Vector corner((i & 1) ? changedMax.x : changedMin.x, (i & 2) ? changedMax.y : changedMin.y, (i & 4) ? changedMax.z : changedMin.z);
+		farthest = max(farthest, VectorLength(corner - g_camera.getPosition()));
+	}
+
+	float footprint = farthest * spacing;
+	visibleMin = changedMin - Vector(footprint, footprint, footprint);
+	visibleMax = changedMax + Vector(footprint, footprint, footprint);
+
+	const float r = g_options.aoRadius;
+	aoMin = changedMin - Vector(r, r, r);
+	aoMax = changedMax + Vector(r, r, r);
+
+	// find and render affected pixels
+	mask.assign(g_width * g_height, 0);
+	parallelFor(g_width, g_options.threads, boost::bind(&SceneEditor::markColumn, this, _1, _2));
+
+	int count = 0;
+	for(unsigned int i = 0; i < mask.size(); i++)count += mask[i];
+
+	if(!count)return 0;
+
+	if((int)columns.size() < g_options.threads)columns.resize(g_options.threads);
+	parallelFor(g_width, g_options.threads, boost::bind(&SceneEditor::renderColumn, this, _1, _2));
+
+	DepthPass();
+
+	// tiles within the blur radius of a rendered pixel, the blur wraps around the image
+	vector<Tile> tiles = generateTiles(g_width, g_height, g_options.tileSize);
+	const int tilesX = (g_width + g_options.tileSize - 1) / g_options.tileSize;
+	const int border = Image::blurSize() / 2;
+
+	vector<char> dirty(tiles.size(), 0);
+
+	for(int y = 0; y < g_height; y++)
+		for(int x = 0; x < g_width; x++)
+		{
+			if(!mask[x + y * g_width])continue;
+
+			// every tile the kernel overlaps, the border may span several tiles. steps go to the start
+			// of the next tile or to the image edge, where the kernel wraps around
+			for(int ky = y - border; ky <= y + border; )
+			{
+				int cy = (ky % g_height + g_height) % g_height;
+
+				for(int kx = x - border; kx <= x + border; )
+				{
+					int cx = (kx % g_width + g_width) % g_width;
+
+					dirty[cx / g_options.tileSize + cy / g_options.tileSize * tilesX] = 1;
+
+					kx += min(g_options.tileSize - cx % g_options.tileSize, g_width - cx);
+				}
+
+				ky += min(g_options.tileSize - cy % g_options.tileSize, g_height - cy);
+			}
+		}
+
+	for(unsigned int i = 0; i < tiles.size(); i++)
+	{
+		if(!dirty[i])continue;
+
+		const Tile& tile = tiles[i];
+
+		STATS_TIMER(PASS_COMPOSITE);
+		TRACE_SCOPE_ARG("composite tile", "composite", i);
+
+		traceLock(img_mutex, "img_mutex");
+		traceLock(ao_mutex, "ao_mutex");
+		traceLock(invao_mutex, "invao_mutex");
+		traceLock(final_mutex, "final_mutex");
+		g_sharedFramebuffer.beginTile(tile);
+
+		g_invao.blurFrom(g_aopass, tile.x, tile.y, tile.x, tile.y, tile.width, tile.height);
+
+		for(int y = tile.y; y < tile.y + tile.height; y++)
+			for(int x = tile.x; x < tile.x + tile.width; x++)
+			{
+				Color inv = Color(1.0f, 1.0f, 1.0f) - g_invao.getPixel(x, y);
+
+				g_invao.setPixel(x, y, inv);
+				g_final.setPixel(x, y, g_image.getPixel(x, y) * inv);
+			}
+
+		g_sharedFramebuffer.publishTile(tile);
+		final_mutex.unlock();
+		invao_mutex.unlock();
+		ao_mutex.unlock();
+		img_mutex.unlock();
+
+		if(output)
+		{
+			// tile data has to start at(0, 0)
+			Image final(tile.width, tile.height);
+
+			for(int y = 0; y < tile.height; y++)
+				for(int x = 0; x < tile.width; x++)final.setPixel(x, y, g_final.getPixel(tile.x + x, tile.y + y));
+
+			output->writeTile(tile, final);
+		}
+	}
+
+	g_sharedFramebuffer.publishFrame(g_GBuffer);
+
+	return count;
+}
+
+bool RunEditBenchmark(const int edits)
+{
+	// full frame for reference
+	Timer timer;
+	RenderMain();
+	double fullTime = timer.elapsed();
+
+	cout<<"full frame: "<<fullTime * 1000.0<<" ms"<<endl;
+
+	// objects around the camera(e.g. the room) would change every pixel
+	vector<int> movable;
+	for(unsigned int i = 0; i < g_objects.size(); i++)
+	{
+		Vector omin, omax;
+		g_objects[i]->getBounds(omin, omax);
+
+		if(!insideBox(g_camera.getPosition(), omin, omax))movable.push_back((int)i);
+	}
+
+	if(movable.empty())
+	{
+		cout<<"no object to move"<<endl;
+		return false;
+	}
+
+	SceneEditor editor;
+	double editTime = 0.0;
+
+	for(int i = 0; i < edits; i++)
+	{
+		int index = movable[rand() % movable.size()];
+
+		Vector offset(random(-1.0f, 1.0f), random(-1.0f, 1.0f), random(-1.0f, 1.0f));
+		offset.normalize();
+		offset = offset * 0.1f;
+
+		editor.moveObject(index, offset);
+
+		timer.restart();
+		int pixels = editor.update();
+		double time = timer.elapsed();
+		editTime += time;
+
+		cout<<"edit "<<i<<": moved object "<<index<<", rendered "<<pixels<<" pixels("
+			<<100.0 * (double)pixels / (double)(g_width * g_height)<<"%) in "<<time * 1000.0<<" ms, "
+			<<100.0 * time / fullTime<<"% of a full frame"<<endl;
+	}
+
+	cout<<edits<<" edits in "<<editTime * 1000.0<<" ms, "<<editTime * 1000.0 / (double)edits<<" ms/edit"<<endl;
+
+	// tiles around the rendered pixels have to be composited again, compare with compositing everything
+	Image final;
+	final.copyFrom(g_final);
+	CompositePass();
+
+	float compositeError = 0.0f;
+	for(int y = 0; y < g_height; y++)
+		for(int x = 0; x < g_width; x++)
+		{
+			Color d = final.getPixel(x, y) - g_final.getPixel(x, y);
+			compositeError = max(compositeError, max(abs(d.r), max(abs(d.g), abs(d.b))));
+		}
+
+	cout<<"largest difference to compositing the whole image: "<<compositeError<<endl;
+
+	// colors and hits are deterministic, they have to match a full render exactly
+	Image image;
+	image.copyFrom(g_image);
+	GBuffer gbuffer(g_GBuffer);
+
+	RenderMain();
+
+	int mismatches = 0;
+	for(int y = 0; y < g_height; y++)
+		for(int x = 0; x < g_width; x++)
+		{
+			Color a = image.getPixel(x, y);
+			Color b = g_image.getPixel(x, y);
+
+			if(a.r != b.r || a.g != b.g || a.b != b.b || gbuffer.getDepth(x, y) != g_GBuffer.getDepth(x, y) ||
+				gbuffer.getObject(x, y) != g_GBuffer.getObject(x, y))mismatches++;
+		}
+
+	cout<<mismatches<<" pixels differ from a full render"<<endl;
+
+	return mismatches == 0 && compositeError < 1e-5f;
+}
\ No newline at end of file
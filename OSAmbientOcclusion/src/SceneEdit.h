@@ -0,0 +1,79 @@
+// Object Space Ambient Occlusion Demo Project
+// (c) 2013 by L.Spiegelberg
+// This code may be redistributed or modified for any learning or teaching purposes
+// but not for any commercial uses
+// to gain further license informations please contact me via
+// spiegelb (at) in.tum.de
+
+#ifndef SCENEEDIT_HEADER_
+#define SCENEEDIT_HEADER_
+
+#include <vector>
+
+#include "Objects.h"
+#include "Tiles.h"
+#include "TileOutput.h"
+
+// edits of g_objects after a frame was rendered. a changed object can only alter pixels whose camera
+// rays pass its old or new bounds in front of their hit, and the ambient occlusion of hit points within
+// the ao radius of these bounds. update renders exactly these pixels again instead of the whole frame,
+// then blurs and composites the tiles around them
+class SceneEditor
+{
+private:
+	/// union of the bounds of all edited objects, before and after the edits
+	Vector				changedMin;
+	Vector				changedMax;
+	bool				changed;
+
+	/// pixels to render again, one byte per pixel of the full size images
+	std::vector<char>	mask;
+
+	/// changed region grown by the footprint of a pixel, for the camera rays
+	Vector				visibleMin;
+	Vector				visibleMax;
+
+	/// changed region grown by the ao radius, for the hit points
+	Vector				aoMin;
+	Vector				aoMax;
+
+	/// ambient occlusion of one column of marked pixels, per thread
+	std::vector<std::vector<Color> >	columns;
+
+	/// add bounds of object to the changed region
+	void touch(IObject *object);
+
+	void markColumn(const int x, const int thread);
+
+	void renderColumn(const int x, const int thread);
+
+public:
+	SceneEditor():changed(false)	{}
+
+	/// append object to g_objects, which takes ownership. returns its index
+	int addObject(IObject *object);
+
+	/// delete object at index, the objects behind it move down by one index
+	bool removeObject(const int index);
+
+	/// move object at index by offset
+	bool moveObject(const int index, const Vector& offset);
+
+	inline bool hasChanges() const	{return changed;}
+
+	/// forget the edits, e.g. because the whole frame is rendered again. the acceleration structures
+	/// still have to be rebuilt
+	inline void reset()	{changed = false;}
+
+	/// rebuild the acceleration structures and render the pixels affected by the edits again. the full
+	/// size images have to hold the last frame of the current camera. recomposited tiles are passed to
+	/// output if given. returns the number of pixels rendered again
+	int update(ITileOutput *output = NULL);
+};
+
+/// render the scene, then move random objects one after another and render after each edit with
+/// SceneEditor::update. prints the time of every update relative to the full frame and checks the
+/// result against a full render at the end. returns false if they differ
+bool RunEditBenchmark(const int edits);
+
+#endif
\ No newline at end of file
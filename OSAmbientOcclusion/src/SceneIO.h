@@ -0,0 +1,203 @@
+// Object Space Ambient Occlusion Demo Project
+// (c) 2013 by L.Spiegelberg
+// This code may be redistributed or modified for any learning or teaching purposes
+// but not for any commercial uses
+// to gain further license informations please contact me via
+// spiegelb (at) in.tum.de
+
+#ifndef SCENEIO_HEADER_
+#define SCENEIO_HEADER_
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+
+#include "Objects.h"
+#include "Instance.h"
+#include "Lights.h"
+#include "Camera.h"
+
+// a scene description is a text with one camera, object or light per line, e.g.
+//	camera <fovy> <position> <lookat> <up> <width> <height>
+//	sphere <radius> <center> <color>
+//	box <min> <max> <color>
+//	triangle <v0> <v1> <v2> <color>
+//	geometry <name> <count>		followed by count sphere, box or triangle lines in local coordinates
+//	instance <name> <matrix> <translation>	places a geometry, the matrix is given row by row
+//	ambientlight <color>
+//	directionallight <color> <direction>
+//	pointlight <color> <position> <range>
+//	spotlight <color> <position> <direction> <range> <angle>	angle is the half opening angle in degrees
+// vectors are written as "x y z", colors as "r g b a"
+
+/// write camera, objects and lights to a scene description
+inline void writeScene(std::ostream& out, Camera& camera, std::vector<IObject*>& objects, std::vector<ILight*>& lights)
+{
+	// enough digits to read the same floats again
+	std::streamsize precision = out.precision(9);
+
+	camera.write(out);
+
+	// shared geometries have to be defined before their instances
+	std::set<Geometry*> written;
+	for(std::vector<IObject*>::iterator it = objects.begin(); it != objects.end(); ++it)
+	{
+		Instance *instance = dynamic_cast<Instance*>(*it);
+
+		if(instance && written.insert(instance->getGeometry().get()).second)instance->getGeometry()->write(out);
+	}
+
+	for(std::vector<IObject*>::iterator it = objects.begin(); it != objects.end(); ++it)
+		(*it)->write(out);
+
+	for(std::vector<ILight*>::iterator it = lights.begin(); it != lights.end(); ++it)
+		(*it)->write(out);
+
+	out.precision(precision);
+}
+
+/// read a sphere, box or triangle after its type, NULL if type is no such object
+inline IObject *readObject(const std::string& type, std::istream& in)
+{
+	if(type == "sphere")
+	{
+		float radius;
+		Vector center;
+		Color color;
+		in>>radius>>center>>color;
+		return new Sphere(radius, center, color);
+	}
+	else if(type == "box")
+	{
+		Vector vmin, vmax;
+		Color color;
+		in>>vmin>>vmax>>color;
+		return new Box(vmin, vmax, color);
+	}
+	else if(type == "triangle")
+	{
+		Vector v0, v1, v2;
+		Color color;
+		in>>v0>>v1>>v2>>color;
+		return new Triangle(v0, v1, v2, color);
+	}
+
+	return NULL;
+}
+
+/// read a scene description, created objects and lights are appended to the lists
+/// returns false on an unknown or malformed line
+inline bool readScene(std::istream& in, Camera& camera, std::vector<IObject*>& objects, std::vector<ILight*>& lights)
+{
+	std::string type;
+
+	// geometries defined so far
+	std::map<std::string, boost::shared_ptr<Geometry> > geometries;
+
+	while(in>>type)
+	{
+		IObject *object = NULL;
+
+		if(type == "camera")
+		{
+			camera.read(in);
+		}
+		else if((object = readObject(type, in)) != NULL)
+		{
+			objects.push_back(object);
+		}
+		else if(type == "geometry")
+		{
+			std::string name;
+			int count = 0;
+			in>>name>>count;
+
+			std::vector<IObject*> local;
+			std::string localType;
+
+			for(int i = 0; i < count && in>>localType; i++)
+			{
+				IObject *o = readObject(localType, in);
+				if(!o)break;
+
+				local.push_back(o);
+			}
+
+			// geometry takes ownership, also of a partially read list
+			geometries[name] = boost::shared_ptr<Geometry>(new Geometry(name, local));
+
+			if((int)local.size() != count)in.setstate(std::ios::failbit);
+		}
+		else if(type == "instance")
+		{
+			std::string name;
+			Matrix3x3 transform;
+			Vector translation;
+			in>>name>>transform>>translation;
+
+			if(!geometries.count(name))
+			{
+				std::cout<<"unknown geometry "<<name<<std::endl;
+				return false;
+			}
+
+			if(std::abs(transform.determinant()) < 1e-12f)
+			{
+				std::cout<<"singular instance transformation"<<std::endl;
+				return false;
+			}
+
+			objects.push_back(new Instance(geometries[name], transform, translation));
+		}
+		else if(type == "ambientlight")
+		{
+			Color color;
+			in>>color;
+			lights.push_back(new AmbientLight(color));
+		}
+		else if(type == "directionallight")
+		{
+			Color color;
+			Vector dir;
+			in>>color>>dir;
+			lights.push_back(new DirectionalLight(color, dir));
+		}
+		else if(type == "pointlight")
+		{
+			Color color;
+			Vector pos;
+			float range = 0.0f;
+			in>>color>>pos>>range;
+
+			if(range <= 0.0f)in.setstate(std::ios::failbit);
+			else lights.push_back(new PointLight(color, pos, range));
+		}
+		else if(type == "spotlight")
+		{
+			Color color;
+			Vector pos, dir;
+			float range = 0.0f, angle = 0.0f;
+			in>>color>>pos>>dir>>range>>angle;
+
+			if(range <= 0.0f || angle <= 0.0f || dir * dir == 0.0f)in.setstate(std::ios::failbit);
+			else lights.push_back(new SpotLight(color, pos, dir, range, angle));
+		}
+		else
+		{
+			std::cout<<"unknown scene entry "<<type<<std::endl;
+			return false;
+		}
+
+		if(in.fail())
+		{
+			std::cout<<"malformed scene entry "<<type<<std::endl;
+			return false;
+		}
+	}
+
+	return true;
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,366 @@
+// Object Space Ambient Occlusion Demo Project
+// (c) 2013 by L.Spiegelberg
+// This code may be redistributed or modified for any learning or teaching purposes
+// but not for any commercial uses
+// to gain further license informations please contact me via
+// spiegelb (at) in.tum.de
+
+#include <cstdio>
+#include <cerrno>
+#include <cstring>
+#include <sstream>
+#include <boost/asio.hpp>
+
+#include "main.h"
+#include "Server.h"
+#include "SocketIO.h"
+#include "Pipeline.h"
+#include "AsyncTileOutput.h"
+#include "SceneEdit.h"
+
+using namespace std;
+
+// protocol, all values are sent in host byte order(client and server run on the same machine)
+//	client -> server:	request magic, width, height, ao samples, layers(bit 1 ao, bit 2 depth),
+//						ao radius, vertical field of view in radians, camera position(x, y, z), look at(x, y, z)
+//						as floats. width 0 ends the connection, a negative width stops the server
+//	server -> client:	reply magic, status(0 = ok, otherwise the request was invalid and nothing follows),
+//						width, height, layers
+//	server -> client:	finished tiles(x, y, width, height) followed by the final color(r, g, b floats)
+//						in the order they are composited, a tile with width 0 ends the image
+//	server -> client:	render time in milliseconds(float), then the requested layers of the whole image:
+//						ambient occlusion and distance along the camera ray(one float per pixel each)
+//
+// scene edits are sent the same way:
+//	client -> server:	edit magic, operation(0 = move, 1 = remove, 2 = add), object index, offset(x, y, z floats)
+//						and the length of a scene description line(see SceneIO.h) followed by the line. only
+//						move uses the offset, only add uses the line
+//	server -> client:	reply magic, status(0 = ok), index of the object
+// a render request with the same settings as the previous one after edits only renders the pixels the
+// edits affect and streams just the tiles around them
+
+static const int request_magic = 0x4f53524f;
+static const int reply_magic = 0x4f535250;
+static const int edit_magic = 0x4f534545;
+
+/// largest image a client may request
+static const int max_size = 16384;
+
+/// layer bits of a request, the final image is always sent
+static const int layer_ao = 2;
+static const int layer_depth = 4;
+
+#ifdef BOOST_ASIO_HAS_LOCAL_SOCKETS
+
+#include <sys/stat.h>
+
+using boost::asio::local::stream_protocol;
+
+/// sends tiles to the client as they are finished
+class SocketTileOutput : public ITileOutput
+{
+private:
+	stream_protocol::socket&	socket;
+	bool						lost;
+
+public:
+	SocketTileOutput(stream_protocol::socket& _socket):socket(_socket), lost(false)	{}
+
+	bool begin(const int /*width*/, const int /*height*/)	{return !lost;}
+
+	void writeTile(const Tile& tile, Image& img)
+	{
+		if(lost)return;
+
+		int msg[4] = {tile.x, tile.y, tile.width, tile.height};
+		if(!send(socket, msg, 4) || !sendImage(socket, img, 3, tile.width, tile.height))lost = true;
+	}
+
+	bool end()	{return !lost;}
+
+	inline bool connectionLost() const	{return lost;}
+};
+
+/// scene edit operations
+enum EditOperation
+{
+	EDIT_MOVE = 0,
+	EDIT_REMOVE,
+	EDIT_ADD
+};
+
+struct RenderRequest
+{
+	int		width;
+	int		height;
+	int		aoSamples;
+	int		layers;
+	float	aoRadius;
+	float	fovy;
+	Vector	position;
+	Vector	lookAt;
+
+	bool operator == (const RenderRequest& r) const
+	{
+		return width == r.width && height == r.height && aoSamples == r.aoSamples && layers == r.layers && aoRadius == r.aoRadius &&
+			fovy == r.fovy && position.x == r.position.x && position.y == r.position.y && position.z == r.position.z &&
+			lookAt.x == r.lookAt.x && lookAt.y == r.lookAt.y && lookAt.z == r.lookAt.z;
+	}
+};
+
+/// receive a request after its magic, returns false if the connection was closed
+static bool receiveRequest(stream_protocol::socket& socket, RenderRequest& request)
+{
+	int header[4];
+	float values[8];
+
+	if(!receive(socket, header, 4))return false;
+
+	request.width		= header[0];
+	request.height		= header[1];
+	request.aoSamples	= header[2];
+	request.layers		= header[3];
+
+	// end of session, nothing else follows
+	if(request.width <= 0)return true;
+
+	if(!receive(socket, values, 8))return false;
+
+	request.aoRadius	= values[0];
+	request.fovy		= values[1];
+	request.position	= Vector(values[2], values[3], values[4]);
+	request.lookAt		= Vector(values[5], values[6], values[7]);
+
+	return true;
+}
+
+/// scene and frame state kept between requests
+class RenderServer
+{
+private:
+	SceneEditor		editor;
+
+	/// settings of the frame in the full size images
+	RenderRequest	last;
+	bool			rendered;
+
+	/// ao radius the acceleration structures were built for, grid cells and the analytic and surfel
+	/// backends are sized by it
+	float			builtRadius;
+
+	bool serveRequest(stream_protocol::socket& socket, const RenderRequest& request);
+
+	bool serveEdit(stream_protocol::socket& socket);
+
+public:
+	RenderServer():rendered(false), builtRadius(g_options.aoRadius)	{}
+
+	/// serve requests of a client, returns false if the client asked to stop the server
+	bool serve(stream_protocol::socket& socket);
+};
+
+/// receive and apply an edit after its magic, returns false if the connection was lost
+bool RenderServer::serveEdit(stream_protocol::socket& socket)
+{
+	int header[2];
+	float offset[3];
+	int length;
+
+	if(!receive(socket, header, 2) || !receive(socket, offset, 3) || !receive(socket, &length, 1) || length < 0 || length > 4096)return false;
+
+	string line(length, ' ');
+	if(length > 0 && !receive(socket, &line[0], line.size()))return false;
+
+	int index = header[1];
+	bool success = false;
+
+	if(header[0] == EDIT_MOVE)success = editor.moveObject(index, Vector(offset[0], offset[1], offset[2]));
+	else if(header[0] == EDIT_REMOVE)success = editor.removeObject(index);
+	else if(header[0] == EDIT_ADD)
+	{
+		istringstream in(line);
+		string type;
+		IObject *object = in>>type ? readObject(type, in) : NULL;
+
+		if(object && !in.fail())
+		{
+			index = editor.addObject(object);
+			success = true;
+		}
+		else delete object;
+	}
+
+	int reply[3] = {reply_magic, success ? 0 : 1, index};
+
+	return send(socket, reply, 3);
+}
+
+/// render request and stream the result, returns false if the connection was lost
+bool RenderServer::serveRequest(stream_protocol::socket& socket, const RenderRequest& request)
+{
+	Timer timer;
+
+	bool valid = request.width <= max_size && request.height > 0 && request.height <= max_size &&
+		request.aoSamples > 0 && request.aoRadius > 0.0f && request.fovy > 0.0f && request.fovy < 3.14159f &&
+		!(request.layers & ~(layer_ao | layer_depth));
+
+	int reply[5] = {reply_magic, valid ? 0 : 1, request.width, request.height, request.layers};
+	if(!send(socket, reply, 5))return false;
+	if(!valid)return true;
+
+	// only the pixels around the edits change
+	bool partial = rendered && editor.hasChanges() && request == last;
+
+	g_options.aoSamples = request.aoSamples;
+	g_options.aoRadius = request.aoRadius;
+
+	// whole frame, acceleration structures have to know about the edits and the ao radius
+	if(!partial && (editor.hasChanges() || request.aoRadius != builtRadius))
+	{
+		buildAccelerators();
+		builtRadius = request.aoRadius;
+		editor.reset();
+	}
+
+	last = request;
+	rendered = true;
+
+	// buffers are only reallocated if the size changed
+	if(request.width != g_width || request.height != g_height)createImages(request.width, request.height);
+
+	int pixels = g_width * g_height;
+	g_camera.setPositionAndLookAt(request.fovy, request.position, request.lookAt, Vector(0, 1, 0), g_width, g_height);
+
+	// socket writes happen on the I/O thread of the output
+	SocketTileOutput *tiles = new SocketTileOutput(socket);
+	{
+		AsyncTileOutput output(tiles);
+		output.begin(g_width, g_height);
+
+		if(partial)pixels = editor.update(&output);
+		else if(g_options.pipeline)RenderPipelined(&output);
+		else
+		{
+			RenderMain();
+			output.writeTile(Tile(0, 0, g_width, g_height), g_final);
+		}
+
+		if(!output.end())return false;
+	}
+
+	int end[4] = {0, 0, 0, 0};
+	float milliseconds = (float)(timer.elapsed() * 1000.0);
+	if(!send(socket, end, 4) || !send(socket, &milliseconds, 1))return false;
+
+	if(request.layers & layer_ao)
+	{
+		if(!sendImage(socket, g_aopass, 1))return false;
+	}
+
+	if(request.layers & layer_depth)
+	{
+		vector<float> depth(g_width * g_height);
+		for(int y = 0; y < g_height; y++)
+			for(int x = 0; x < g_width; x++)depth[x + y * g_width] = g_GBuffer.getDepth(x, y);
+
+		if(!send(socket, &depth[0], depth.size()))return false;
+	}
+
+	cout<<"request "<<g_width<<"x"<<g_height<<", "<<g_options.aoSamples<<" ao samples, "<<pixels<<" pixels rendered: "
+		<<timer.elapsed() * 1000.0<<" ms ("<<milliseconds<<" ms until the last tile)"<<endl;
+
+	return true;
+}
+
+bool RenderServer::serve(stream_protocol::socket& socket)
+{
+	int magic;
+
+	while(receive(socket, &magic, 1))
+	{
+		if(magic == edit_magic)
+		{
+			if(!serveEdit(socket))break;
+		}
+		else if(magic == request_magic)
+		{
+			RenderRequest request;
+			if(!receiveRequest(socket, request))break;
+
+			if(request.width < 0)return false;
+			if(request.width == 0 || !serveRequest(socket, request))break;
+		}
+		else break;
+	}
+
+	return true;
+}
+
+bool RunServer(const std::string& path)
+{
+	boost::asio::io_service io;
+	stream_protocol::acceptor acceptor(io);
+	boost::system::error_code ec;
+
+	// socket file of an earlier server, anything else at path is kept
+	struct stat info;
+	if(lstat(path.c_str(), &info) == 0)
+	{
+		if(!S_ISSOCK(info.st_mode))
+		{
+			cout<<path<<" exists and is not a socket"<<endl;
+			return false;
+		}
+
+		remove(path.c_str());
+	}
+	else if(errno != ENOENT)
+	{
+		cout<<"could not check "<<path<<": "<<strerror(errno)<<endl;
+		return false;
+	}
+
+	stream_protocol::endpoint endpoint(path);
+	acceptor.open(endpoint.protocol(), ec);
+	if(!ec)acceptor.bind(endpoint, ec);
+	if(!ec)acceptor.listen(boost::asio::socket_base::max_connections, ec);
+
+	if(ec)
+	{
+		cout<<"could not listen on "<<path<<": "<<ec.message()<<endl;
+		return false;
+	}
+
+	cout<<"render server listening on "<<path<<endl;
+
+	RenderServer server;
+
+	bool running = true;
+	while(running)
+	{
+		stream_protocol::socket socket(io);
+		acceptor.accept(socket, ec);
+		if(ec)
+		{
+			cout<<"accept failed: "<<ec.message()<<endl;
+			break;
+		}
+
+		running = server.serve(socket);
+	}
+
+	acceptor.close();
+	remove(path.c_str());
+
+	return true;
+}
+
+#else
+
+bool RunServer(const std::string& path)
+{
+	cout<<"the render server needs unix domain sockets, which are not available on this platform"<<endl;
+	return false;
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,23 @@
+// Object Space Ambient Occlusion Demo Project
+// (c) 2013 by L.Spiegelberg
+// This code may be redistributed or modified for any learning or teaching purposes
+// but not for any commercial uses
+// to gain further license informations please contact me via
+// spiegelb (at) in.tum.de
+
+#ifndef SERVER_HEADER_
+#define SERVER_HEADER_
+
+#include <string>
+
+// render server: the scene, acceleration structures, buffers and render threads stay in memory and
+// clients send render requests over a unix domain socket. each request renders one frame of the
+// loaded scene with its own camera, size and ambient occlusion settings and streams the composited
+// tiles back as soon as they are finished. clients are served one after another, a connection may
+// send any number of requests
+
+/// serve render requests on the unix socket at path until a client asks to stop,
+/// returns false if the socket could not be created or the platform has no unix sockets
+bool RunServer(const std::string& path);
+
+#endif
\ No newline at end of file
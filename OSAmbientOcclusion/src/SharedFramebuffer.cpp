@@ -0,0 +1,148 @@
+// Object Space Ambient Occlusion Demo Project
+// (c) 2013 by L.Spiegelberg
+// This code may be redistributed or modified for any learning or teaching purposes
+// but not for any commercial uses
+// to gain further license informations please contact me via
+// spiegelb (at) in.tum.de
+
+#include <fstream>
+#include <cstring>
+#include <boost/interprocess/detail/atomic.hpp>
+
+#include "main.h"
+#include "SharedFramebuffer.h"
+
+using namespace std;
+using namespace boost::interprocess;
+
+static const int format_size[3] = {0, 4 * sizeof(float), sizeof(float)};
+
+bool SharedFramebuffer::open(const string& filename, const int width, const int height, const int tileSize, const int layers,
+							 Image& final, Image& ao)
+{
+	// layout, sequences and layers start at 64 byte boundaries
+	SharedFramebufferHeader h;
+	memset(&h, 0, sizeof(h));
+	memcpy(h.magic, "OSAOFB2", 8);
+	h.headerSize = sizeof(h);
+	h.width = width;
+	h.height = height;
+
+	h.tileSize = tileSize;
+	h.tilesX = (width + tileSize - 1) / tileSize;
+	h.tilesY = (height + tileSize - 1) / tileSize;
+
+	h.format[LAYER_FINAL] = FORMAT_ARGB32F;
+	h.format[LAYER_AO] = (layers & (1 << LAYER_AO)) ? FORMAT_ARGB32F : FORMAT_NONE;
+	h.format[LAYER_DEPTH] = (layers & (1 << LAYER_DEPTH)) ? FORMAT_R32F : FORMAT_NONE;
+
+	unsigned long long size = (sizeof(h) + 63) & ~63ULL;
+
+	h.sequenceOffset = size;
+	size += ((unsigned long long)sizeof(unsigned int) * h.tilesX * h.tilesY + 63) & ~63ULL;
+
+	for(int i = 0; i < LAYER_COUNT; i++)
+	{
+		if(h.format[i] == FORMAT_NONE)continue;
+
+		h.offset[i] = size;
+		size += ((unsigned long long)format_size[h.format[i]] * width * height + 63) & ~63ULL;
+	}
+
+	// the image data is used as is, it has to be the layer format
+	if(sizeof(Color) != 4 * sizeof(float))
+	{
+		cout<<"color layout does not match the shared framebuffer format"<<endl;
+		return false;
+	}
+
+	try
+	{
+		// create file of the full size
+		{
+			filebuf file;
+			if(!file.open(filename.c_str(), ios_base::in | ios_base::out | ios_base::trunc | ios_base::binary))
+			{
+				cout<<"could not create shared framebuffer "<<filename<<endl;
+				return false;
+			}
+
+			file.pubseekoff(size - 1, ios_base::beg);
+			file.sputc(0);
+		}
+
+		file_mapping(filename.c_str(), read_write).swap(mapping);
+		mapped_region(mapping, read_write, 0, (size_t)size).swap(region);
+	}
+	catch(interprocess_exception& e)
+	{
+		cout<<"could not map shared framebuffer "<<filename<<": "<<e.what()<<endl;
+		return false;
+	}
+
+	header = (SharedFramebufferHeader*)region.get_address();
+	*header = h;
+
+	// render directly into the mapped memory
+	final.attach((Color*)layer(LAYER_FINAL), width, height);
+	if(hasLayer(LAYER_AO))ao.attach((Color*)layer(LAYER_AO), width, height);
+
+	return true;
+}
+
+void SharedFramebuffer::incrementSequences(const Tile& rect)
+{
+	volatile unsigned int *sequence = (volatile unsigned int*)((char*)region.get_address() + header->sequenceOffset);
+	int tileSize = (int)header->tileSize;
+
+	for(int ty = rect.y / tileSize; ty <= (rect.y + rect.height - 1) / tileSize; ty++)
+		for(int tx = rect.x / tileSize; tx <= (rect.x + rect.width - 1) / tileSize; tx++)
+			ipcdetail::atomic_inc32(&sequence[tx + ty * header->tilesX]);
+}
+
+void SharedFramebuffer::beginTile(const Tile& rect)
+{
+	if(!header)return;
+
+	// odd, readers discard what they copy from now on
+	incrementSequences(rect);
+}
+
+void SharedFramebuffer::publishTile(const Tile& rect)
+{
+	if(!header)return;
+
+	// full barriers, pixels written before are visible once the sequence is even again
+	incrementSequences(rect);
+	ipcdetail::atomic_inc32(&header->tiles);
+}
+
+void SharedFramebuffer::publishFrame(GBuffer& gbuffer)
+{
+	if(!header)return;
+
+	if(hasLayer(LAYER_DEPTH) && gbuffer.getWidth() == (int)header->width && gbuffer.getHeight() == (int)header->height)
+	{
+		float *depth = (float*)layer(LAYER_DEPTH);
+
+		for(int y = 0; y < gbuffer.getHeight(); y++)
+			for(int x = 0; x < gbuffer.getWidth(); x++)depth[x + y * gbuffer.getWidth()] = gbuffer.getDepth(x, y);
+	}
+
+	ipcdetail::atomic_inc32(&header->frame);
+}
+
+bool parseSharedLayers(const vector<string>& names, int& layers)
+{
+	layers = 1 << LAYER_FINAL;
+
+	for(vector<string>::const_iterator it = names.begin(); it != names.end(); ++it)
+	{
+		if(*it == "final")layers |= 1 << LAYER_FINAL;
+		else if(*it == "ao")layers |= 1 << LAYER_AO;
+		else if(*it == "depth")layers |= 1 << LAYER_DEPTH;
+		else return false;
+	}
+
+	return true;
+}
\ No newline at end of file
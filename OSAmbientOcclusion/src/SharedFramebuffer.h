@@ -0,0 +1,121 @@
+// Object Space Ambient Occlusion Demo Project
+// (c) 2013 by L.Spiegelberg
+// This code may be redistributed or modified for any learning or teaching purposes
+// but not for any commercial uses
+// to gain further license informations please contact me via
+// spiegelb (at) in.tum.de
+
+#ifndef SHAREDFRAMEBUFFER_HEADER_
+#define SHAREDFRAMEBUFFER_HEADER_
+
+#include <string>
+#include <vector>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include "Image.h"
+#include "GBuffer.h"
+#include "Tiles.h"
+
+// the final image(and optionally the ambient occlusion and the depth) can live in a memory mapped file,
+// e.g. in /dev/shm, so other processes see finished pixels without any copy. the file starts with a
+// SharedFramebufferHeader followed by the tile sequence numbers and the layers.
+//
+// the final image is split into tiles of tileSize pixels(smaller at the right and bottom border), row by
+// row. each tile has a sequence number which is odd while the tile is written and even once it is done,
+// so a reader polling the final image does for tile i:
+//	1. read s = sequence[i], if s is odd the tile is being written, try again later
+//	2. copy the pixels of the tile
+//	3. read sequence[i] again, if it is not s the tile was overwritten meanwhile(e.g. by the next frame)
+//	   and the copy has to be discarded
+// a tile whose sequence did not change since the last poll holds the same pixels. the counter tiles is
+// incremented after every finished tile, frame after a whole image(including the ao and depth layers,
+// which are not covered by the sequences) is complete
+
+/// layers of the shared framebuffer
+enum SharedLayer
+{
+	LAYER_FINAL = 0,	// composited color, alpha, red, green, blue as 32 bit float
+	LAYER_AO,			// ambient occlusion, alpha, red, green, blue as 32 bit float
+	LAYER_DEPTH,		// distance along the camera ray, 32 bit float(no_hit_distance if nothing was hit)
+	LAYER_COUNT
+};
+
+/// pixel formats of the layers
+enum SharedFormat
+{
+	FORMAT_NONE = 0,	// layer not present
+	FORMAT_ARGB32F,
+	FORMAT_R32F
+};
+
+/// start of the mapped file, all fields are little endian on the usual platforms
+struct SharedFramebufferHeader
+{
+	/// "OSAOFB2" and a zero
+	char				magic[8];
+
+	/// size of this header in bytes
+	unsigned int		headerSize;
+
+	unsigned int		width;
+	unsigned int		height;
+
+	/// completed images
+	volatile unsigned int	frame;
+
+	/// finished tiles of the final image since the start
+	volatile unsigned int	tiles;
+
+	/// edge length of a tile and the number of tiles in a row and a column
+	unsigned int		tileSize;
+	unsigned int		tilesX;
+	unsigned int		tilesY;
+
+	/// position of the sequence numbers(one 32 bit unsigned int per tile) from the start of the file
+	unsigned long long	sequenceOffset;
+
+	/// SharedFormat of each layer
+	unsigned int		format[LAYER_COUNT];
+
+	/// position of each layer from the start of the file, rows are stored top down without padding
+	unsigned long long	offset[LAYER_COUNT];
+};
+
+class SharedFramebuffer
+{
+private:
+	boost::interprocess::file_mapping	mapping;
+	boost::interprocess::mapped_region	region;
+
+	SharedFramebufferHeader	*header;
+
+	inline char *layer(const SharedLayer l)	{return (char*)region.get_address() + header->offset[l];}
+
+	/// increment the sequence numbers of all tiles overlapping rect
+	void incrementSequences(const Tile& rect);
+
+public:
+	SharedFramebuffer():header(NULL)	{}
+
+	/// create or overwrite filename with the given layers(bit i set = layer i present) and tiles of tileSize,
+	/// attach the final and ambient occlusion image to it. returns false on failure
+	bool open(const std::string& filename, const int width, const int height, const int tileSize, const int layers,
+			  Image& final, Image& ao);
+
+	inline bool hasLayer(const SharedLayer l) const	{return header && header->format[l] != FORMAT_NONE;}
+
+	/// the final image is about to be written in rect(a tile or e.g. the whole image)
+	void beginTile(const Tile& rect);
+
+	/// rect of the final image is complete
+	void publishTile(const Tile& rect);
+
+	/// whole image is complete, the depth layer is filled from gbuffer
+	void publishFrame(GBuffer& gbuffer);
+};
+
+/// layer names(final, ao, depth) to layer bits, the final image is always present. returns false on an unknown name
+bool parseSharedLayers(const std::vector<std::string>& names, int& layers);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,80 @@
+// Object Space Ambient Occlusion Demo Project
+// (c) 2013 by L.Spiegelberg
+// This code may be redistributed or modified for any learning or teaching purposes
+// but not for any commercial uses
+// to gain further license informations please contact me via
+// spiegelb (at) in.tum.de
+
+#ifndef SOCKETIO_HEADER_
+#define SOCKETIO_HEADER_
+
+#include <vector>
+#include <boost/asio.hpp>
+
+#include "Image.h"
+
+// blocking transfer of raw values over asio stream sockets(tcp or unix domain), values are sent in
+// host byte order. all functions return false if the connection was lost
+
+template<typename Socket, typename T> bool send(Socket& socket, const T *data, const size_t count)
+{
+	boost::system::error_code ec;
+	boost::asio::write(socket, boost::asio::buffer(data, count * sizeof(T)), ec);
+	return !ec;
+}
+
+template<typename Socket, typename T> bool receive(Socket& socket, T *data, const size_t count)
+{
+	boost::system::error_code ec;
+	boost::asio::read(socket, boost::asio::buffer(data, count * sizeof(T)), ec);
+	return !ec;
+}
+
+/// send first channels(1 = red only, 3 = rgb) of width x height pixels of img starting at(0, 0)
+template<typename Socket> bool sendImage(Socket& socket, Image& img, const int channels, const int width, const int height)
+{
+	std::vector<float> data(width * height * channels);
+
+	for(int y = 0; y < height; y++)
+		for(int x = 0; x < width; x++)
+		{
+			Color c = img.getPixel(x, y);
+			float *p = &data[(x + y * width) * channels];
+
+			p[0] = c.r;
+			if(channels == 3)
+			{
+				p[1] = c.g;
+				p[2] = c.b;
+			}
+		}
+
+	return send(socket, &data[0], data.size());
+}
+
+/// send first channels of all pixels
+template<typename Socket> bool sendImage(Socket& socket, Image& img, const int channels)
+{
+	return sendImage(socket, img, channels, img.getWidth(), img.getHeight());
+}
+
+/// receive image sent with sendImage, img has to have the right size
+template<typename Socket> bool receiveImage(Socket& socket, Image& img, const int channels)
+{
+	std::vector<float> data(img.getWidth() * img.getHeight() * channels);
+
+	if(!receive(socket, &data[0], data.size()))return false;
+
+	for(int y = 0; y < img.getHeight(); y++)
+		for(int x = 0; x < img.getWidth(); x++)
+		{
+			const float *p = &data[(x + y * img.getWidth()) * channels];
+
+			if(channels == 3)img.setPixel(x, y, Color(p[0], p[1], p[2]));
+			else img.setPixel(x, y, Color(p[0], p[0], p[0]));
+		}
+
+	return true;
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,152 @@
+// Object Space Ambient Occlusion Demo Project
+// (c) 2013 by L.Spiegelberg
+// This code may be redistributed or modified for any learning or teaching purposes
+// but not for any commercial uses
+// to gain further license informations please contact me via
+// spiegelb (at) in.tum.de
+
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <boost/thread/mutex.hpp>
+
+#include "Stats.h"
+
+using namespace std;
+
+static const char *pass_names[PASS_COUNT] = {"raytrace", "ao", "blur", "composite", "frame", "output"};
+
+// statistics of all threads that ever rendered, kept until program ends
+// so threads can be aggregated after they finished
+static vector<RenderStats*>	g_threadStats;
+static boost::mutex			g_statsMutex;
+
+// buffer memory
+static long long			g_bufferMemory = 0;
+static long long			g_peakBufferMemory = 0;
+
+static OSAO_THREAD_LOCAL RenderStats *t_stats = NULL;
+
+RenderStats& localStats()
+{
+	// first call of this thread, register
+	if(!t_stats)
+	{
+		RenderStats *stats = new RenderStats();
+
+		g_statsMutex.lock();
+		g_threadStats.push_back(stats);
+		g_statsMutex.unlock();
+
+		t_stats = stats;
+	}
+
+	return *t_stats;
+}
+
+RenderStats gatherStats()
+{
+	RenderStats res;
+
+	g_statsMutex.lock();
+	for(vector<RenderStats*>::iterator it = g_threadStats.begin(); it != g_threadStats.end(); ++it)
+	{
+		const RenderStats& s = **it;
+
+		res.primaryRays			+= s.primaryRays;
+		res.aaRays				+= s.aaRays;
+		res.aoRays				+= s.aoRays;
+		res.intersectionTests	+= s.intersectionTests;
+		res.hits				+= s.hits;
+		res.lightEvaluations	+= s.lightEvaluations;
+		res.pixels				+= s.pixels;
+
+		for(int i = 0; i < PASS_COUNT; i++)
+		{
+			res.passTime[i] += s.passTime[i];
+			res.passMaxTime[i] = max(res.passMaxTime[i], s.passTime[i]);
+		}
+	}
+	g_statsMutex.unlock();
+
+	return res;
+}
+
+void resetStats()
+{
+	g_statsMutex.lock();
+	for(vector<RenderStats*>::iterator it = g_threadStats.begin(); it != g_threadStats.end(); ++it)
+		(*it)->clear();
+
+	g_peakBufferMemory = g_bufferMemory;
+	g_statsMutex.unlock();
+}
+
+void trackBufferMemory(const long long bytes)
+{
+	g_statsMutex.lock();
+	g_bufferMemory += bytes;
+	g_peakBufferMemory = max(g_peakBufferMemory, g_bufferMemory);
+	g_statsMutex.unlock();
+}
+
+long long peakBufferMemory()
+{
+	g_statsMutex.lock();
+	long long res = g_peakBufferMemory;
+	g_statsMutex.unlock();
+
+	return res;
+}
+
+void printStats(ostream& out, const RenderStats& stats)
+{
+#ifndef OSAO_STATS
+	(void)stats;
+	out<<"statistics not available, compile with OSAO_STATS"<<endl;
+#else
+	double frameTime = stats.passMaxTime[PASS_FRAME];
+	double pixels = stats.pixels > 0 ? (double)stats.pixels : 1.0;
+	double rays = stats.rays() > 0 ? (double)stats.rays() : 1.0;
+
+	out<<"render statistics"<<endl
+		<<"  rays           "<<stats.rays()<<" (primary "<<stats.primaryRays<<", aa "<<stats.aaRays<<", ao "<<stats.aoRays<<")"<<endl
+		<<"  rays/s         "<<(frameTime > 0.0 ? (double)stats.rays() / frameTime : 0.0)<<endl
+		<<"  tests          "<<stats.intersectionTests<<" ("<<(double)stats.intersectionTests / rays<<" per ray)"<<endl
+		<<"  hits           "<<stats.hits<<" ("<<100.0 * (double)stats.hits / rays<<"%)"<<endl
+		<<"  lights         "<<stats.lightEvaluations<<" ("<<(double)stats.lightEvaluations / pixels<<" per pixel)"<<endl
+		<<"  samples/pixel  "<<(double)(stats.primaryRays + stats.aaRays) / pixels<<" color, "<<(double)stats.aoRays / pixels<<" ao"<<endl
+		<<"  peak memory    "<<peakBufferMemory() / 1024<<" KB"<<endl;
+
+	for(int i = 0; i < PASS_COUNT; i++)
+	{
+		out<<"  "<<pass_names[i]<<string(15 - string(pass_names[i]).size(), ' ')
+			<<stats.passMaxTime[i] * 1000.0<<" ms (all threads "<<stats.passTime[i] * 1000.0<<" ms)"<<endl;
+	}
+#endif
+}
+
+void writeStatsJSON(ostream& out, const RenderStats& stats)
+{
+	double frameTime = stats.passMaxTime[PASS_FRAME];
+
+	out<<"{"<<endl
+		<<"  \"primary_rays\": "<<stats.primaryRays<<","<<endl
+		<<"  \"aa_rays\": "<<stats.aaRays<<","<<endl
+		<<"  \"ao_rays\": "<<stats.aoRays<<","<<endl
+		<<"  \"rays_per_second\": "<<(frameTime > 0.0 ? (double)stats.rays() / frameTime : 0.0)<<","<<endl
+		<<"  \"intersection_tests\": "<<stats.intersectionTests<<","<<endl
+		<<"  \"hits\": "<<stats.hits<<","<<endl
+		<<"  \"light_evaluations\": "<<stats.lightEvaluations<<","<<endl
+		<<"  \"pixels\": "<<stats.pixels<<","<<endl
+		<<"  \"peak_buffer_memory\": "<<peakBufferMemory()<<","<<endl
+		<<"  \"passes\": {";
+
+	for(int i = 0; i < PASS_COUNT; i++)
+	{
+		out<<(i ? "," : "")<<endl<<"    \""<<pass_names[i]<<"\": {\"wall_seconds\": "<<stats.passMaxTime[i]
+			<<", \"thread_seconds\": "<<stats.passTime[i]<<"}";
+	}
+
+	out<<endl<<"  }"<<endl<<"}"<<endl;
+}
\ No newline at end of file
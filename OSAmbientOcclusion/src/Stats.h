@@ -0,0 +1,118 @@
+// Object Space Ambient Occlusion Demo Project
+// (c) 2013 by L.Spiegelberg
+// This code may be redistributed or modified for any learning or teaching purposes
+// but not for any commercial uses
+// to gain further license informations please contact me via
+// spiegelb (at) in.tum.de
+
+#ifndef STATS_HEADER_
+#define STATS_HEADER_
+
+#include <iostream>
+
+#include "Timer.h"
+
+// render statistics are only gathered if OSAO_STATS is defined, otherwise
+// the STATS_ macros expand to nothing and cost nothing
+
+// thread local storage
+#ifdef _MSC_VER
+#define OSAO_THREAD_LOCAL __declspec(thread)
+#else
+#define OSAO_THREAD_LOCAL __thread
+#endif
+
+/// timed passes
+enum RenderPass
+{
+	PASS_RAYTRACE = 0,
+	PASS_AO,
+	PASS_BLUR,
+	PASS_COMPOSITE,
+	PASS_FRAME,		// whole image
+	PASS_OUTPUT,	// encoding and writing finished tiles
+	PASS_COUNT
+};
+
+/// counters of a single thread
+struct RenderStats
+{
+	// rays by type
+	unsigned long long primaryRays;
+	unsigned long long aaRays;
+	unsigned long long aoRays;
+
+	/// IObject::intersect calls
+	unsigned long long intersectionTests;
+
+	/// rays that hit an object
+	unsigned long long hits;
+
+	/// ILight::shade calls
+	unsigned long long lightEvaluations;
+
+	/// raytraced pixels
+	unsigned long long pixels;
+
+	/// time spent in each pass(seconds)
+	double passTime[PASS_COUNT];
+
+	/// longest time a single thread spent in each pass, only set by gatherStats
+	double passMaxTime[PASS_COUNT];
+
+	RenderStats()	{clear();}
+
+	void clear()
+	{
+		primaryRays = aaRays = aoRays = 0;
+		intersectionTests = hits = lightEvaluations = pixels = 0;
+
+		for(int i = 0; i < PASS_COUNT; i++)passTime[i] = passMaxTime[i] = 0.0;
+	}
+
+	inline unsigned long long rays() const	{return primaryRays + aaRays + aoRays;}
+};
+
+/// statistics of the calling thread
+RenderStats& localStats();
+
+/// sum of the statistics of all threads
+RenderStats gatherStats();
+
+/// zero statistics of all threads and the peak memory
+void resetStats();
+
+/// account allocation(positive) or release(negative) of image buffers
+void trackBufferMemory(const long long bytes);
+
+/// highest amount of buffer memory allocated at once since last reset
+long long peakBufferMemory();
+
+/// print statistics in human readable form
+void printStats(std::ostream& out, const RenderStats& stats);
+
+/// write statistics as JSON object
+void writeStatsJSON(std::ostream& out, const RenderStats& stats);
+
+/// adds the lifetime of the object to the pass time of the calling thread
+class PassTimer
+{
+private:
+	RenderPass	pass;
+	Timer		timer;
+public:
+	PassTimer(const RenderPass _pass):pass(_pass)	{}
+	~PassTimer()	{localStats().passTime[pass] += timer.elapsed();}
+};
+
+#ifdef OSAO_STATS
+#define STATS_ADD(counter, n)		(localStats().counter += (n))
+#define STATS_TIMER(pass)			PassTimer pass_timer_(pass)
+#define STATS_MEMORY(bytes)			trackBufferMemory(bytes)
+#else
+#define STATS_ADD(counter, n)		((void)0)
+#define STATS_TIMER(pass)			((void)0)
+#define STATS_MEMORY(bytes)			((void)0)
+#endif
+
+#endif
\ No newline at end of file
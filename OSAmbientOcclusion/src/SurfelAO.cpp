@@ -0,0 +1,390 @@
+// Object Space Ambient Occlusion Demo Project
+// (c) 2013 by L.Spiegelberg
+// This code may be redistributed or modified for any learning or teaching purposes
+// but not for any commercial uses
+// to gain further license informations please contact me via
+// spiegelb (at) in.tum.de
+
+#include <algorithm>
+#include <cmath>
+
+#include "main.h"
+#include "SurfelAO.h"
+
+using namespace std;
+
+static const float pi = 3.14159265f;
+
+static const int stack_size = 128;
+
+/// triangles are split at most this often(4^depth surfels)
+static const int max_split_depth = 10;
+
+static inline float clampf(const float f, const float fmin, const float fmax)	{return min(max(f, fmin), fmax);}
+
+static inline float component(const Vector& v, const int axis)	{return axis == 0 ? v.x : (axis == 1 ? v.y : v.z);}
+
+/// direction bin of a normal, its dominant axis and sign
+static inline int normalBin(const Vector& n)
+{
+	Vector a = VectorAbs(n);
+
+	if(a.x >= a.y && a.x >= a.z)return n.x >= 0.0f ? 0 : 1;
+	if(a.y >= a.z)return n.y >= 0.0f ? 2 : 3;
+	return n.z >= 0.0f ? 4 : 5;
+}
+
+/// is p inside a sphere or box? false for all other objects
+static bool containsPoint(IObject *object, const Vector& p)
+{
+	if(Sphere *sphere = dynamic_cast<Sphere*>(object))return VectorLength(p - sphere->getCenter()) < sphere->getRadius();
+
+	if(Box *box = dynamic_cast<Box*>(object))
+	{
+		Vector vmin = box->getNearPoint();
+		Vector vmax = box->getFarPoint();
+
+		return p.x > vmin.x && p.x < vmax.x && p.y > vmin.y && p.y < vmax.y && p.z > vmin.z && p.z < vmax.z;
+	}
+
+	return false;
+}
+
+/// compares surfels by their position along an axis
+struct SurfelLess
+{
+	int axis;
+
+	SurfelLess(const int _axis):axis(_axis)	{}
+
+	template<typename T> bool operator () (const T& a, const T& b) const
+	{
+		return component(a.position, axis) < component(b.position, axis);
+	}
+};
+
+void SurfelAO::addTriangle(const Vector& v0, const Vector& v1, const Vector& v2, const Vector& normal, const float size, const int depth)
+{
+	Vector e0 = v1 - v0, e1 = v2 - v1, e2 = v0 - v2;
+	float longest = max(e0 * e0, max(e1 * e1, e2 * e2));
+
+	if(longest > size * size && depth < max_split_depth)
+	{
+		Vector m01 = (v0 + v1) * 0.5f, m12 = (v1 + v2) * 0.5f, m20 = (v2 + v0) * 0.5f;
+
+		addTriangle(v0, m01, m20, normal, size, depth + 1);
+		addTriangle(m01, v1, m12, normal, size, depth + 1);
+		addTriangle(m20, m12, v2, normal, size, depth + 1);
+		addTriangle(m01, m12, m20, normal, size, depth + 1);
+		return;
+	}
+
+	Surfel s;
+	s.position = (v0 + v1 + v2) / 3.0f;
+	s.normal = normal;
+	s.area = 0.5f * VectorLength(e0.crossproduct(v2 - v0));
+
+	if(s.area > 0.0f)surfels.push_back(s);
+}
+
+void SurfelAO::addSurfels(IObject *object, const float size, const bool inward)
+{
+	float flip = inward ? -1.0f : 1.0f;
+
+	if(Sphere *sphere = dynamic_cast<Sphere*>(object))
+	{
+		// rings of patches with about the same edge length, the areas add up to the sphere exactly
+		float r = sphere->getRadius();
+		int rings = max(2, (int)ceil(pi * r / size));
+
+		for(int i = 0; i < rings; i++)
+		{
+			float theta0 = pi * (float)i / (float)rings, theta1 = pi * (float)(i + 1) / (float)rings;
+			float theta = 0.5f * (theta0 + theta1);
+			int segments = max(3, (int)ceil(2.0f * pi * r * sin(theta) / size));
+
+			for(int j = 0; j < segments; j++)
+			{
+				float phi = 2.0f * pi * ((float)j + 0.5f) / (float)segments;
+				Vector n(sin(theta) * cos(phi), cos(theta), sin(theta) * sin(phi));
+
+				Surfel s;
+				s.position = sphere->getCenter() + n * r;
+				s.normal = n * flip;
+				s.area = r * r * (cos(theta0) - cos(theta1)) * 2.0f * pi / (float)segments;
+				surfels.push_back(s);
+			}
+		}
+	}
+	else if(Box *box = dynamic_cast<Box*>(object))
+	{
+		Vector vmin = box->getNearPoint();
+		Vector vmax = box->getFarPoint();
+		Vector extent = vmax - vmin;
+
+		for(int axis = 0; axis < 3; axis++)
+		{
+			int u = (axis + 1) % 3;
+			int v = (axis + 2) % 3;
+
+			int cellsU = max(1, (int)ceil(component(extent, u) / size));
+			int cellsV = max(1, (int)ceil(component(extent, v) / size));
+			float du = component(extent, u) / (float)cellsU;
+			float dv = component(extent, v) / (float)cellsV;
+
+			for(int side = 0; side < 2; side++)
+			{
+				float c[3];
+				c[axis] = side ? component(vmax, axis) : component(vmin, axis);
+
+				float n[3] = {0.0f, 0.0f, 0.0f};
+				n[axis] = (side ? 1.0f : -1.0f) * flip;
+
+				for(int i = 0; i < cellsU; i++)
+					for(int j = 0; j < cellsV; j++)
+					{
+						c[u] = component(vmin, u) + ((float)i + 0.5f) * du;
+						c[v] = component(vmin, v) + ((float)j + 0.5f) * dv;
+
+						Surfel s;
+						s.position = Vector(c[0], c[1], c[2]);
+						s.normal = Vector(n[0], n[1], n[2]);
+						s.area = du * dv;
+						surfels.push_back(s);
+					}
+			}
+		}
+	}
+	else if(Triangle *triangle = dynamic_cast<Triangle*>(object))
+	{
+		// a single triangle is no closed surface, it occludes from both sides
+		const Vector& n = triangle->getNormal();
+		addTriangle(triangle->getVertex(0), triangle->getVertex(1), triangle->getVertex(2), n, size, 0);
+		addTriangle(triangle->getVertex(0), triangle->getVertex(2), triangle->getVertex(1), -n, size, 0);
+	}
+	else if(Instance *instance = dynamic_cast<Instance*>(object))
+	{
+		const Matrix3x3& transform = instance->getTransform();
+
+		// surfels are made in local space, smaller by the largest scale of the transformation
+		float scale = max(VectorLength(transform * Vector(1, 0, 0)), max(VectorLength(transform * Vector(0, 1, 0)), VectorLength(transform * Vector(0, 0, 1))));
+		if(scale <= 0.0f)return;
+
+		const vector<IObject*>& parts = instance->getGeometry()->getObjects();
+
+		for(vector<IObject*>::const_iterator it = parts.begin(); it != parts.end(); ++it)
+		{
+			unsigned int start = surfels.size();
+
+			// the triangles of a geometry form closed meshes, only their front side occludes
+			if(Triangle *triangle = dynamic_cast<Triangle*>(*it))
+				addTriangle(triangle->getVertex(0), triangle->getVertex(1), triangle->getVertex(2), triangle->getNormal(), size / scale, 0);
+			else addSurfels(*it, size / scale, false);
+
+			// to world space, the area scales with the transformed tangents
+			for(unsigned int i = start; i < surfels.size(); i++)
+			{
+				Surfel& s = surfels[i];
+
+				Vector tangent, binormal;
+				hemisphereBasis(s.normal, tangent, binormal);
+
+				Vector t = transform * tangent;
+				Vector b = transform * binormal;
+				Vector n = t.crossproduct(b);
+				float length = VectorLength(n);
+
+				n = n / length;
+				if(n * (instance->getNormalMatrix() * s.normal) < 0.0f)n = -n;
+
+				s.position = transform * s.position + instance->getTranslation();
+				s.normal = n;
+				s.area *= length;
+			}
+		}
+	}
+}
+
+int SurfelAO::build(const int first, const int count)
+{
+	int index = (int)nodes.size();
+	nodes.push_back(Node());
+
+	// summary of the cluster
+	Node node;
+	float area = 0.0f;
+	Vector center(0.0f, 0.0f, 0.0f);
+	Vector bmin = surfels[first].position, bmax = surfels[first].position;
+
+	for(int i = 0; i < 6; i++)
+	{
+		node.normals[i] = Vector(0.0f, 0.0f, 0.0f);
+		node.spread[i] = 0.0f;
+	}
+
+	for(int i = first; i < first + count; i++)
+	{
+		const Surfel& s = surfels[i];
+
+		area += s.area;
+		center += s.position * s.area;
+		bmin = VectorMin(bmin, s.position);
+		bmax = VectorMax(bmax, s.position);
+
+		int bin = normalBin(s.normal);
+		node.normals[bin] += s.normal * s.area;
+		node.spread[bin] += s.area;
+	}
+
+	node.center = center / area;
+
+	// area of a bin not explained by its mean normal occludes evenly in all directions
+	for(int i = 0; i < 6; i++)node.spread[i] = max(0.0f, node.spread[i] - VectorLength(node.normals[i]));
+
+	node.radius = 0.0f;
+	for(int i = first; i < first + count; i++)
+	{
+		const Surfel& s = surfels[i];
+		node.radius = max(node.radius, VectorLength(s.position - node.center) + sqrt(s.area / pi));
+	}
+
+	if(count <= max_leaf_size)
+	{
+		node.first = first;
+		node.count = count;
+		node.second = 0;
+		nodes[index] = node;
+
+		return index;
+	}
+
+	// median split along the longest axis
+	Vector extent = bmax - bmin;
+	int axis = extent.x >= extent.y && extent.x >= extent.z ? 0 : (extent.y >= extent.z ? 1 : 2);
+	int half = count / 2;
+
+	nth_element(surfels.begin() + first, surfels.begin() + first + half, surfels.begin() + first + count, SurfelLess(axis));
+
+	node.first = 0;
+	node.count = 0;
+
+	build(first, half);
+	node.second = build(first + half, count - half);
+	nodes[index] = node;
+
+	return index;
+}
+
+void SurfelAO::build(const vector<IObject*>& objects, const float aoRadius, const float size, const float maxError)
+{
+	surfels.clear();
+	nodes.clear();
+
+	radius = aoRadius;
+	error = maxError;
+
+	vector<Vector> centers(objects.size());
+	for(unsigned int i = 0; i < objects.size(); i++)
+	{
+		Vector vmin, vmax;
+		objects[i]->getBounds(vmin, vmax);
+		centers[i] = (vmin + vmax) * 0.5f;
+	}
+
+	for(unsigned int i = 0; i < objects.size(); i++)
+	{
+		// spheres and boxes holding other objects are rooms, they are seen from the inside
+		bool inward = false;
+		for(unsigned int j = 0; j < objects.size() && !inward; j++)inward = j != i && containsPoint(objects[i], centers[j]);
+
+		addSurfels(objects[i], size * aoRadius, inward);
+	}
+
+	if(surfels.empty())return;
+
+	nodes.reserve(surfels.size() / 2 + 1);
+	build(0, (int)surfels.size());
+}
+
+float SurfelAO::diskOcclusion(const Vector& v, const float d, const float projected, const float extent, const Vector& normal) const
+{
+	if(projected <= 0.0f)return 0.0f;
+
+	// solid angle of a disk of the projected area facing the point, relative to the hemisphere
+	float r2 = projected / pi;
+	float solid = 1.0f - d / sqrt(d * d + r2);
+
+	// part above the tangent plane, the disk is cut by a line at the elevation of its center
+	float angle = atan(sqrt(r2) / d);
+	float elevation = asin(clampf(normal * v / d, -1.0f, 1.0f));
+	float h = clampf(elevation / angle, -1.0f, 1.0f);
+	float visible = 1.0f - (acos(h) - h * sqrt(1.0f - h * h)) / pi;
+
+	// part within the ao radius
+	float inside = clampf((radius - d + extent) / (2.0f * extent), 0.0f, 1.0f);
+
+	return solid * visible * inside;
+}
+
+float SurfelAO::occlusion(const Vector& point, const Vector& normal) const
+{
+	static const float epsilon = 0.0001f;
+
+	if(nodes.empty())return 0.0f;
+
+	int stack[stack_size];
+	int top = 0;
+	stack[top++] = 0;
+
+	float sum = 0.0f;
+	int evaluated = 0;
+
+	while(top > 0 && sum < 1.0f)
+	{
+		int index = stack[--top];
+		const Node& node = nodes[index];
+
+		Vector v = node.center - point;
+		float d = VectorLength(v);
+
+		// farther than the ao radius or below the tangent plane
+		if(d - node.radius >= radius || normal * v < -node.radius)continue;
+
+		if(node.count)
+		{
+			for(int i = node.first; i < node.first + node.count; i++)
+			{
+				const Surfel& s = surfels[i];
+
+				Vector sv = s.position - point;
+				float sd = VectorLength(sv);
+				if(sd < epsilon)continue;
+
+				// disk facing the point, its area is foreshortened
+				float projected = -(s.normal * sv) / sd * s.area;
+				sum += diskOcclusion(sv, sd, projected, sqrt(s.area / pi), normal);
+			}
+
+			evaluated += node.count;
+		}
+		else if(node.radius < error * d)
+		{
+			// cluster as one disk, each direction bin facing the point adds its foreshortened area
+			float projected = 0.0f;
+			for(int i = 0; i < 6; i++)projected += max(0.0f, -(node.normals[i] * v) / d) + 0.25f * node.spread[i];
+
+			sum += diskOcclusion(v, d, projected, node.radius, normal);
+			evaluated++;
+		}
+		else
+		{
+			stack[top++] = node.second;
+			stack[top++] = index + 1;
+		}
+	}
+
+	// evaluated disks and clusters are counted as intersection tests
+	STATS_ADD(intersectionTests, evaluated);
+
+	return min(sum, 1.0f);
+}
\ No newline at end of file
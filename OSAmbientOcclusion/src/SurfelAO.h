@@ -0,0 +1,89 @@
+// Object Space Ambient Occlusion Demo Project
+// (c) 2013 by L.Spiegelberg
+// This code may be redistributed or modified for any learning or teaching purposes
+// but not for any commercial uses
+// to gain further license informations please contact me via
+// spiegelb (at) in.tum.de
+
+#ifndef SURFELAO_HEADER_
+#define SURFELAO_HEADER_
+
+#include <vector>
+
+#include "Objects.h"
+
+/// point based ambient occlusion(after Bunnell, "Dynamic Ambient Occlusion and Indirect Lighting", GPU Gems 2).
+/// all surfaces are covered with small oriented disks(surfels), which are grouped in a hierarchy of clusters.
+/// a point sums the solid angle of the disks in front of it within the ao radius, clusters that look small
+/// enough from the point are taken as one disk instead of visiting their surfels. no rays are traced, the
+/// result is smooth but overlapping disks are counted twice(clamped to 1)
+class SurfelAO
+{
+private:
+	/// oriented disk, only occludes points on the side its normal points to
+	struct Surfel
+	{
+		Vector	position;
+		Vector	normal;
+		float	area;
+	};
+
+	/// node of the flattened tree, children of inner nodes are stored at index + 1 and second.
+	/// the surfels of a cluster are summarized per dominant normal direction(+x, -x, +y, ...): normals
+	/// holds the sum of area * normal, spread the part of the area not explained by it. flat clusters
+	/// like box faces are represented exactly
+	struct Node
+	{
+		Vector	center;		// area weighted mean position
+		float	radius;		// bounding sphere around center, including the surfel disks
+		int		second;		// inner node: index of second child
+		int		first;		// leaf: first surfel
+		int		count;		// leaf: number of surfels, 0 for inner nodes
+		Vector	normals[6];
+		float	spread[6];
+	};
+
+	/// surfels per leaf
+	static const int max_leaf_size = 4;
+
+	/// surfels reordered so leaves reference contiguous ranges
+	std::vector<Surfel>	surfels;
+	std::vector<Node>	nodes;
+
+	float	radius;
+	float	error;
+
+	/// add surfels of edge length size covering an object, closed objects containing others(rooms) face inwards
+	void addSurfels(IObject *object, const float size, const bool inward);
+
+	/// add surfels of a triangle, split until its edges are shorter than size
+	void addTriangle(const Vector& v0, const Vector& v1, const Vector& v2, const Vector& normal, const float size, const int depth);
+
+	/// build node for surfels[first, first + count)
+	int build(const int first, const int count);
+
+	/// fraction of the hemisphere occluded by a disk of projected area at offset v from the point
+	float diskOcclusion(const Vector& v, const float d, const float projected, const float extent, const Vector& normal) const;
+
+	// no copies
+	SurfelAO(const SurfelAO&);
+	SurfelAO& operator = (const SurfelAO&);
+
+public:
+	SurfelAO():radius(1.0f), error(0.25f)	{}
+
+	/// cover the objects with surfels of edge length size * aoRadius. clusters are used as one disk if their
+	/// radius is less than maxError times their distance, smaller values are more accurate but slower
+	void build(const std::vector<IObject*>& objects, const float aoRadius, const float size, const float maxError);
+
+	/// fraction of the hemisphere around normal that is occluded within the ao radius
+	float occlusion(const Vector& point, const Vector& normal) const;
+
+	inline int getSurfelCount() const	{return (int)surfels.size();}
+	inline int getNodeCount() const	{return (int)nodes.size();}
+
+	/// memory of surfels and tree
+	inline long long bytes() const	{return (long long)(surfels.size() * sizeof(Surfel) + nodes.size() * sizeof(Node));}
+};
+
+#endif
\ No newline at end of file
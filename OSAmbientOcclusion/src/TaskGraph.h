@@ -0,0 +1,220 @@
+// Object Space Ambient Occlusion Demo Project
+// (c) 2013 by L.Spiegelberg
+// This code may be redistributed or modified for any learning or teaching purposes
+// but not for any commercial uses
+// to gain further license informations please contact me via
+// spiegelb (at) in.tum.de
+
+#ifndef TASKGRAPH_HEADER_
+#define TASKGRAPH_HEADER_
+
+#include <cassert>
+#include <vector>
+#include <algorithm>
+#include <boost/thread.hpp>
+#include <boost/function.hpp>
+#include <boost/bind.hpp>
+
+#include "Parallel.h"
+
+/// runs tasks as soon as all tasks they depend on are done. tasks made ready by a finished
+/// task are run next, so the work of a tile is finished before new tiles are started.
+/// a task may be owned by a thread, which then runs it unless it is busy while others are idle.
+/// the graph can be run again, once it has been run with the same number of threads no memory is allocated
+class TaskGraph
+{
+private:
+	/// double ended queue of task indices with a fixed capacity, memory is kept when it is emptied
+	class Queue
+	{
+	private:
+		std::vector<int>	items;
+		int					first;
+		int					count;
+
+	public:
+		Queue():first(0), count(0)	{}
+
+		/// remove all tasks, capacity is the number of tasks that fit
+		void reset(const int capacity)
+		{
+			if((int)items.size() < capacity)items.resize(capacity);
+			first = 0;
+			count = 0;
+		}
+
+		inline bool empty() const	{return count == 0;}
+
+		void push_front(const int index)
+		{
+			assert(count < (int)items.size());
+			first = first == 0 ? (int)items.size() - 1 : first - 1;
+			items[first] = index;
+			count++;
+		}
+
+		void push_back(const int index)
+		{
+			assert(count < (int)items.size());
+			items[(first + count) % items.size()] = index;
+			count++;
+		}
+
+		int pop_front()
+		{
+			int index = items[first];
+			first = (first + 1) % (int)items.size();
+			count--;
+			return index;
+		}
+
+		int pop_back()
+		{
+			count--;
+			return items[(first + count) % items.size()];
+		}
+	};
+
+	struct Task
+	{
+		/// task body, called with the number of the thread
+		boost::function<void (int)>	func;
+
+		/// tasks waiting for this one
+		std::vector<int>			successors;
+
+		/// tasks this one waits for and how many of them are unfinished
+		int							dependencies;
+		int							pending;
+
+		/// thread preferred to run the task, -1 for any
+		int							owner;
+	};
+
+	std::vector<Task>			tasks;
+
+	boost::mutex				mutex;
+	boost::condition_variable	cond;
+
+	/// ready tasks without owner and ready tasks of each thread
+	Queue					ready;
+	std::vector<Queue>		owned;
+	int								readyCount;
+	int								remaining;
+
+	/// queue a ready task, at the front if it should run next
+	void push(const int index, const bool front)
+	{
+		int owner = tasks[index].owner;
+		Queue& queue = owner >= 0 && owner < (int)owned.size() ? owned[owner] : ready;
+
+		if(front)queue.push_front(index);
+		else queue.push_back(index);
+
+		readyCount++;
+	}
+
+	/// next task for thread, own tasks first. tasks of other threads are taken from the back,
+	/// where their owner would get to them last
+	int pop(const int thread)
+	{
+		readyCount--;
+
+		if(thread < (int)owned.size() && !owned[thread].empty())return owned[thread].pop_front();
+
+		if(!ready.empty())return ready.pop_front();
+
+		for(unsigned int i = 0; i < owned.size(); i++)
+			if(!owned[i].empty())return owned[i].pop_back();
+
+		assert(false);
+		return -1;
+	}
+
+	void work(const int thread)
+	{
+		boost::mutex::scoped_lock lock(mutex);
+
+		while(true)
+		{
+			while(readyCount == 0 && remaining > 0)cond.wait(lock);
+
+			if(remaining == 0)return;
+
+			int index = pop(thread);
+
+			lock.unlock();
+			tasks[index].func(thread);
+			lock.lock();
+
+			remaining--;
+
+			// successors of a task go first, in the order they were added
+			std::vector<int>& successors = tasks[index].successors;
+			for(int i = (int)successors.size() - 1; i >= 0; i--)
+				if(--tasks[successors[i]].pending == 0)push(successors[i], true);
+
+			cond.notify_all();
+		}
+	}
+
+public:
+	TaskGraph():readyCount(0), remaining(0)	{}
+
+	/// add task, returns its index. owner is the thread that should run it, -1 for any
+	int add(const boost::function<void (int)>& func, const int owner = -1)
+	{
+		Task task;
+		task.func = func;
+		task.dependencies = 0;
+		task.pending = 0;
+		task.owner = owner;
+
+		tasks.push_back(task);
+
+		return (int)tasks.size() - 1;
+	}
+
+	/// task may only start after other is done
+	void depend(const int task, const int other)
+	{
+		tasks[other].successors.push_back(task);
+		tasks[task].dependencies++;
+	}
+
+	inline int size() const	{return (int)tasks.size();}
+
+	/// remove all tasks
+	void clear()
+	{
+		tasks.clear();
+	}
+
+	/// run all tasks with numThreads threads, returns when all are done
+	void run(const int numThreads)
+	{
+		int count = (int)tasks.size();
+
+		ready.reset(count);
+		owned.resize(std::max(numThreads, 1));
+		for(unsigned int i = 0; i < owned.size(); i++)owned[i].reset(count);
+		readyCount = 0;
+
+		for(unsigned int i = 0; i < tasks.size(); i++)tasks[i].pending = tasks[i].dependencies;
+
+		for(unsigned int i = 0; i < tasks.size(); i++)
+			if(tasks[i].pending == 0)push((int)i, false);
+
+		remaining = (int)tasks.size();
+
+		if(numThreads <= 1)
+		{
+			work(0);
+			return;
+		}
+
+		ThreadPool::instance().run(numThreads, boost::bind(&TaskGraph::work, this, _1));
+	}
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,136 @@
+// Object Space Ambient Occlusion Demo Project
+// (c) 2013 by L.Spiegelberg
+// This code may be redistributed or modified for any learning or teaching purposes
+// but not for any commercial uses
+// to gain further license informations please contact me via
+// spiegelb (at) in.tum.de
+
+#include <cmath>
+
+#include "main.h"
+#include "Temporal.h"
+
+using namespace std;
+
+const float TemporalAO::depth_tolerance = 0.01f;
+const float TemporalAO::normal_tolerance = 0.9f;
+
+int TemporalAO::reproject(const Vector& point, const Vector& normal)
+{
+	float fX, fY;
+	if(!camera.project(point, fX, fY))return -1;
+
+	int px = (int)floor(fX + 0.5f);
+	int py = (int)floor(fY + 0.5f);
+
+	float tolerance = depth_tolerance * VectorLength(point - camera.getPosition());
+	float bestDistance = tolerance;
+	int best = -1;
+
+	// the surface point of a pixel moves a bit, search the neighbourhood for the nearest one
+	for(int y = py - 1; y <= py + 1; y++)
+		for(int x = px - 1; x <= px + 1; x++)
+		{
+			if(x < 0 || y < 0 || x >= history.getWidth() || y >= history.getHeight())continue;
+
+			float distance = VectorLength(history.getPoint(x, y) - point);
+
+			if(distance < bestDistance && history.getNormal(x, y) * normal > normal_tolerance)
+			{
+				bestDistance = distance;
+				best = x + y * history.getWidth();
+			}
+		}
+
+	return best;
+}
+
+void TemporalAO::renderColumn(const int x, const int thread)
+{
+	int columnReused = 0;
+	long long columnSamples = 0;
+
+	vector<Color>& column = columns[thread];
+	column.resize(gbuffer->getHeight());
+
+	for(int y = 0; y < gbuffer->getHeight(); y++)
+	{
+		int index = x + y * gbuffer->getWidth();
+
+		Vector point = gbuffer->getPoint(x, y);
+		Vector normal = gbuffer->getNormal(x, y);
+
+		// nothing hit
+		if(normal * normal == 0.0f)
+		{
+			nextOcclusion[index] = 0.0f;
+			nextSamples[index] = 0;
+			column[y] = Color::black;
+			continue;
+		}
+
+		float occ = 0.0f;
+		int count = 0;
+
+		int prev = valid ? reproject(point, normal) : -1;
+		if(prev >= 0)
+		{
+			occ = occlusion[prev];
+			count = samples[prev];
+			columnReused++;
+		}
+
+		// add samples till converged
+		if(count < targetSamples)
+		{
+			int n = min(stepSamples, targetSamples - count);
+
+			occ = (occ * (float)count + computeAO(point, normal, n) * (float)n) / (float)(count + n);
+			count += n;
+			columnSamples += n;
+		}
+
+		nextOcclusion[index] = occ;
+		nextSamples[index] = count;
+		column[y] = Color(occ, occ, occ);
+	}
+
+	for(int y = 0; y < gbuffer->getHeight(); y++)ao->setPixel(x, y, column[y]);
+
+	mutex.lock();
+	reused += columnReused;
+	newSamples += columnSamples;
+	mutex.unlock();
+}
+
+void TemporalAO::render(GBuffer& _gbuffer, const Camera& cam, Image& _ao, const int target, const int step, const int threads)
+{
+	STATS_TIMER(PASS_AO);
+	TRACE_SCOPE("ao", "pass");
+
+	gbuffer = &_gbuffer;
+	ao = &_ao;
+	targetSamples = target;
+	stepSamples = max(1, min(step, target));
+	reused = 0;
+	newSamples = 0;
+
+	int size = gbuffer->getWidth() * gbuffer->getHeight();
+
+	// history of another resolution can not be used
+	if(history.getWidth() != gbuffer->getWidth() || history.getHeight() != gbuffer->getHeight())valid = false;
+
+	nextOcclusion.resize(size);
+	nextSamples.resize(size);
+
+	if((int)columns.size() < threads)columns.resize(threads);
+
+	parallelFor(gbuffer->getWidth(), threads, boost::bind(&TemporalAO::renderColumn, this, _1, _2));
+
+	// current frame becomes history
+	history = *gbuffer;
+	occlusion.swap(nextOcclusion);
+	samples.swap(nextSamples);
+	camera = cam;
+	valid = true;
+}
\ No newline at end of file
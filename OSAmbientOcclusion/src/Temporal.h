@@ -0,0 +1,76 @@
+// Object Space Ambient Occlusion Demo Project
+// (c) 2013 by L.Spiegelberg
+// This code may be redistributed or modified for any learning or teaching purposes
+// but not for any commercial uses
+// to gain further license informations please contact me via
+// spiegelb (at) in.tum.de
+
+#ifndef TEMPORAL_HEADER_
+#define TEMPORAL_HEADER_
+
+#include <vector>
+
+#include "GBuffer.h"
+#include "Camera.h"
+#include "Image.h"
+
+/// reuses ambient occlusion of the previous frame. ambient occlusion of a surface point does not
+/// depend on the camera, so every pixel whose surface was already visible in the previous frame takes
+/// over its accumulated samples and only disoccluded or unconverged pixels get new samples
+class TemporalAO
+{
+private:
+	/// previous frame
+	GBuffer				history;
+	std::vector<float>	occlusion;
+	std::vector<int>	samples;
+	Camera				camera;
+	bool				valid;
+
+	/// current frame, swapped with the history afterwards
+	std::vector<float>	nextOcclusion;
+	std::vector<int>	nextSamples;
+
+	/// one column per thread, kept over frames
+	std::vector<std::vector<Color> >	columns;
+
+	// settings of the current frame
+	GBuffer	*gbuffer;
+	Image	*ao;
+	int		targetSamples;
+	int		stepSamples;
+
+	// counters of the current frame
+	boost::mutex	mutex;
+	int				reused;
+	long long		newSamples;
+
+	/// look up surface point in the previous frame, returns index of the history pixel or -1
+	int reproject(const Vector& point, const Vector& normal);
+
+	void renderColumn(const int x, const int thread);
+
+public:
+	/// points closer than this fraction of their distance to the camera are the same surface
+	static const float depth_tolerance;
+
+	/// minimal cosine between the normals of the same surface
+	static const float normal_tolerance;
+
+	TemporalAO():valid(false), gbuffer(NULL), ao(NULL), targetSamples(0), stepSamples(0), reused(0), newSamples(0)	{}
+
+	/// forget history, e.g. after a cut
+	inline void reset()	{valid = false;}
+
+	/// ambient occlusion for the points and normals of gbuffer seen from cam, written to ao.
+	/// pixels are converged with target samples, new or unconverged pixels get at most step samples per frame
+	void render(GBuffer& _gbuffer, const Camera& cam, Image& _ao, const int target, const int step, const int threads);
+
+	/// pixels of the last frame that could be taken over from the previous frame
+	inline int getReusedPixels() const	{return reused;}
+
+	/// ambient occlusion rays shot in the last frame
+	inline long long getNewSamples() const	{return newSamples;}
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,174 @@
+// Object Space Ambient Occlusion Demo Project
+// (c) 2013 by L.Spiegelberg
+// This code may be redistributed or modified for any learning or teaching purposes
+// but not for any commercial uses
+// to gain further license informations please contact me via
+// spiegelb (at) in.tum.de
+
+#ifndef TILEOUTPUT_HEADER_
+#define TILEOUTPUT_HEADER_
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "Image.h"
+#include "Tiles.h"
+
+/// receives finished tiles of an image
+class ITileOutput
+{
+public:
+	virtual ~ITileOutput()	{}
+
+	/// start a new image, returns false on failure
+	virtual bool begin(const int width, const int height) = 0;
+
+	/// store a finished tile, img holds the tile data starting at (0, 0)
+	virtual void writeTile(const Tile& tile, Image& img) = 0;
+
+	/// image is complete, returns false if a tile or the file could not be written
+	virtual bool end() = 0;
+};
+
+// 64 bit file positions, images may be larger than 2 GB
+#ifdef _WIN32
+inline int fseek64(FILE *file, const long long offset)	{return _fseeki64(file, offset, SEEK_SET);}
+#else
+inline int fseek64(FILE *file, const long long offset)	{return fseeko(file, (off_t)offset, SEEK_SET);}
+#endif
+
+/// writes tiles directly to their place in a binary PPM file,
+/// so the image never needs to be held in memory as a whole
+class PPMTileOutput : public ITileOutput
+{
+private:
+	std::string filename;
+	FILE		*file;
+
+	int width;
+	int height;
+
+	/// size of the header in bytes
+	long long	headerSize;
+
+	/// a tile could not be written
+	bool		failed;
+
+	/// one row of a tile in 8 bit rgb
+	std::vector<unsigned char> row;
+
+public:
+	PPMTileOutput(const std::string& _filename):filename(_filename), file(NULL), width(0), height(0), headerSize(0), failed(false)	{}
+
+	~PPMTileOutput()
+	{
+		end();
+	}
+
+	bool begin(const int _width, const int _height)
+	{
+		end();
+
+		width = _width;
+		height = _height;
+		failed = false;
+
+		file = fopen(filename.c_str(), "wb");
+		if(!file)
+		{
+			std::cout<<"could not open "<<filename<<" for writing"<<std::endl;
+			return false;
+		}
+
+		// write header
+		int res = fprintf(file, "P6\n%d %d\n255\n", width, height);
+		if(res < 0)
+		{
+			end();
+			return false;
+		}
+		headerSize = res;
+
+		// reserve space for the whole image by writing the last byte
+		long long size = headerSize + 3LL * width * height;
+		if(fseek64(file, size - 1) || fputc(0, file) == EOF)
+		{
+			std::cout<<"could not write "<<filename<<std::endl;
+			end();
+			return false;
+		}
+
+		return true;
+	}
+
+	void writeTile(const Tile& tile, Image& img)
+	{
+		if(!file)return;
+
+		STATS_TIMER(PASS_OUTPUT);
+
+		row.resize(3 * tile.width);
+
+		for(int y = 0; y < tile.height; y++)
+		{
+			// convert row
+			for(int x = 0; x < tile.width; x++)
+			{
+				Color c = img.getPixel(x, y);
+				row[3 * x]		= (unsigned char)c.getRed();
+				row[3 * x + 1]	= (unsigned char)c.getGreen();
+				row[3 * x + 2]	= (unsigned char)c.getBlue();
+			}
+
+			// seek to row position in file
+			long long offset = headerSize + 3LL * ((long long)(tile.y + y) * width + tile.x);
+			if(fseek64(file, offset) || fwrite(&row[0], 1, row.size(), file) != row.size())
+			{
+				std::cout<<"could not write tile "<<tile.x<<", "<<tile.y<<" to "<<filename<<std::endl;
+				failed = true;
+				return;
+			}
+		}
+	}
+
+	bool end()
+	{
+		if(!file)return !failed;
+
+		// buffered rows may only fail when flushed
+		if(fclose(file))
+		{
+			std::cout<<"could not write "<<filename<<std::endl;
+			failed = true;
+		}
+		file = NULL;
+
+		return !failed;
+	}
+};
+
+/// write a whole image as binary PPM, returns false on failure
+inline bool writePPM(const std::string& filename, Image& img)
+{
+	PPMTileOutput output(filename);
+	if(!output.begin(img.getWidth(), img.getHeight()))return false;
+
+	output.writeTile(Tile(0, 0, img.getWidth(), img.getHeight()), img);
+
+	return output.end();
+}
+
+/// name of a further output next to filename, e.g. out.ppm and bent give out_bent.ppm
+inline std::string outputName(const std::string& filename, const std::string& suffix)
+{
+	size_t dot = filename.rfind('.');
+	size_t slash = filename.find_last_of("/\\");
+
+	// no extension
+	if(dot == std::string::npos || (slash != std::string::npos && dot < slash))return filename + "_" + suffix;
+
+	return filename.substr(0, dot) + "_" + suffix + filename.substr(dot);
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,41 @@
+// Object Space Ambient Occlusion Demo Project
+// (c) 2013 by L.Spiegelberg
+// This code may be redistributed or modified for any learning or teaching purposes
+// but not for any commercial uses
+// to gain further license informations please contact me via
+// spiegelb (at) in.tum.de
+
+#ifndef TILES_HEADER_
+#define TILES_HEADER_
+
+#include <vector>
+#include <algorithm>
+
+/// rectangular part of the image
+struct Tile
+{
+	int x;
+	int y;
+	int width;
+	int height;
+
+	Tile():x(0), y(0), width(0), height(0)	{}
+
+	Tile(const int _x, const int _y, const int _width, const int _height):x(_x), y(_y), width(_width), height(_height)	{}
+};
+
+/// split image into tiles(row by row), tiles at the right/bottom border may be smaller
+inline std::vector<Tile> generateTiles(const int width, const int height, const int tileSize)
+{
+	std::vector<Tile> tiles;
+
+	for(int y = 0; y < height; y += tileSize)
+		for(int x = 0; x < width; x += tileSize)
+		{
+			tiles.push_back(Tile(x, y, std::min(tileSize, width - x), std::min(tileSize, height - y)));
+		}
+
+	return tiles;
+}
+
+#endif
\ No newline at end of file
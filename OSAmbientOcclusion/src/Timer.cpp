@@ -0,0 +1,42 @@
+// Object Space Ambient Occlusion Demo Project
+// (c) 2013 by L.Spiegelberg
+// This code may be redistributed or modified for any learning or teaching purposes
+// but not for any commercial uses
+// to gain further license informations please contact me via
+// spiegelb (at) in.tum.de
+
+#include "Timer.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+
+double getTime()
+{
+	static double frequency = 0.0;
+
+	LARGE_INTEGER counter;
+
+	if(frequency == 0.0)
+	{
+		QueryPerformanceFrequency(&counter);
+		frequency = (double)counter.QuadPart;
+	}
+
+	QueryPerformanceCounter(&counter);
+
+	return (double)counter.QuadPart / frequency;
+}
+
+#else
+#include <time.h>
+
+double getTime()
+{
+	timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (double)ts.tv_sec + 1e-9 * (double)ts.tv_nsec;
+}
+
+#endif
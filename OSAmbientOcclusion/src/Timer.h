@@ -0,0 +1,28 @@
+// Object Space Ambient Occlusion Demo Project
+// (c) 2013 by L.Spiegelberg
+// This code may be redistributed or modified for any learning or teaching purposes
+// but not for any commercial uses
+// to gain further license informations please contact me via
+// spiegelb (at) in.tum.de
+
+#ifndef TIMER_HEADER_
+#define TIMER_HEADER_
+
+/// high resolution time in seconds since an arbitrary point
+double getTime();
+
+/// measures time since construction or last restart
+class Timer
+{
+private:
+	double start;
+public:
+	Timer():start(getTime())	{}
+
+	inline void		restart()			{start = getTime();}
+
+	/// elapsed time in seconds
+	inline double	elapsed() const		{return getTime() - start;}
+};
+
+#endif
@@ -0,0 +1,165 @@
+// Object Space Ambient Occlusion Demo Project
+// (c) 2013 by L.Spiegelberg
+// This code may be redistributed or modified for any learning or teaching purposes
+// but not for any commercial uses
+// to gain further license informations please contact me via
+// spiegelb (at) in.tum.de
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+#include "Trace.h"
+#include "Stats.h"
+
+using namespace std;
+
+bool g_tracing = false;
+
+/// one finished scope
+struct TraceEvent
+{
+	const char	*name;
+	const char	*category;
+	double		start;
+	double		duration;
+	int			arg;
+};
+
+/// events of one thread, only this thread writes to it
+struct TraceBuffer
+{
+	vector<TraceEvent>	events;
+
+	/// events recorded so far, the latest is at (count - 1) % events.size()
+	unsigned long long	count;
+
+	string				name;
+	int					id;
+};
+
+// buffers of all threads that ever recorded, kept until the trace is written
+static vector<TraceBuffer*>		g_traceBuffers;
+static boost::mutex				g_traceMutex;
+static int						g_traceCapacity = 0;
+static double					g_traceStart = 0.0;
+
+static OSAO_THREAD_LOCAL TraceBuffer *t_trace = NULL;
+
+/// buffer of the calling thread
+static TraceBuffer& localTrace()
+{
+	// first event of this thread, register
+	if(!t_trace)
+	{
+		TraceBuffer *buffer = new TraceBuffer();
+		buffer->events.resize(g_traceCapacity);
+		buffer->count = 0;
+
+		g_traceMutex.lock();
+		buffer->id = (int)g_traceBuffers.size();
+		g_traceBuffers.push_back(buffer);
+		g_traceMutex.unlock();
+
+		ostringstream name;
+		name<<"thread "<<buffer->id;
+		buffer->name = name.str();
+
+		t_trace = buffer;
+	}
+
+	return *t_trace;
+}
+
+void startTrace(const int eventsPerThread)
+{
+	g_traceCapacity = eventsPerThread;
+	g_traceStart = getTime();
+	g_tracing = true;
+}
+
+void setTraceThreadName(const string& name)
+{
+	if(g_tracing)localTrace().name = name;
+}
+
+void traceEvent(const char *name, const char *category, const double start, const int arg)
+{
+	TraceBuffer& buffer = localTrace();
+
+	// oldest events are overwritten
+	TraceEvent& e = buffer.events[buffer.count % buffer.events.size()];
+	e.name = name;
+	e.category = category;
+	e.start = start;
+	e.duration = getTime() - start;
+	e.arg = arg;
+
+	buffer.count++;
+}
+
+void traceContendedLock(boost::mutex& mutex, const char *name)
+{
+	// free locks are not worth an event
+	if(mutex.try_lock())return;
+
+	double start = getTime();
+	mutex.lock();
+
+	traceEvent(name, "lock", start, -1);
+}
+
+bool writeTrace(const string& filename)
+{
+	ofstream file(filename.c_str());
+	if(!file)
+	{
+		cout<<"could not write trace to "<<filename<<endl;
+		return false;
+	}
+
+	file.precision(15);
+	file<<"{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+
+	bool first = true;
+	unsigned long long events = 0, dropped = 0;
+
+	g_traceMutex.lock();
+	for(unsigned int i = 0; i < g_traceBuffers.size(); i++)
+	{
+		const TraceBuffer& buffer = *g_traceBuffers[i];
+
+		file<<(first ? "" : ",")<<"\n{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": "<<buffer.id
+			<<", \"args\": {\"name\": \""<<buffer.name<<"\"}}";
+		first = false;
+
+		// oldest event first
+		unsigned long long size = buffer.events.size();
+		unsigned long long begin = buffer.count > size ? buffer.count - size : 0;
+
+		for(unsigned long long j = begin; j < buffer.count; j++)
+		{
+			const TraceEvent& e = buffer.events[j % size];
+
+			// microseconds since the start of the trace
+			file<<",\n{\"name\": \""<<e.name<<"\", \"cat\": \""<<e.category<<"\", \"ph\": \"X\", \"pid\": 1, \"tid\": "<<buffer.id
+				<<", \"ts\": "<<(e.start - g_traceStart) * 1e6<<", \"dur\": "<<e.duration * 1e6;
+
+			if(e.arg >= 0)file<<", \"args\": {\"index\": "<<e.arg<<"}";
+			file<<"}";
+		}
+
+		events += buffer.count - begin;
+		dropped += begin;
+	}
+	g_traceMutex.unlock();
+
+	file<<"\n]}\n";
+
+	cout<<"trace of "<<events<<" events written to "<<filename;
+	if(dropped)cout<<", "<<dropped<<" older events were overwritten";
+	cout<<endl;
+
+	return file.good();
+}
\ No newline at end of file
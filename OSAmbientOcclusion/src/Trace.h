@@ -0,0 +1,75 @@
+// Object Space Ambient Occlusion Demo Project
+// (c) 2013 by L.Spiegelberg
+// This code may be redistributed or modified for any learning or teaching purposes
+// but not for any commercial uses
+// to gain further license informations please contact me via
+// spiegelb (at) in.tum.de
+
+#ifndef TRACE_HEADER_
+#define TRACE_HEADER_
+
+#include <string>
+#include <boost/thread/mutex.hpp>
+
+#include "Timer.h"
+
+// timeline of the passes, tiles, texture updates and lock waits of all threads, written as Chrome trace
+// JSON(chrome://tracing or ui.perfetto.dev). every thread records into an own ring buffer nobody else
+// writes to, so no lock is taken. if tracing is off a scope costs a branch on g_tracing, which never
+// changes during a run
+
+/// set by startTrace before any thread renders
+extern bool g_tracing;
+
+/// begin recording, every thread keeps its last eventsPerThread events
+void startTrace(const int eventsPerThread);
+
+/// name of the calling thread in the timeline, e.g. "pool 2"
+void setTraceThreadName(const std::string& name);
+
+/// record an event of the calling thread from start(see getTime) until now. name and category have to be
+/// string literals, arg is shown with the event unless it is negative(e.g. the tile index)
+void traceEvent(const char *name, const char *category, const double start, const int arg);
+
+/// write all recorded events, returns false if the file could not be written
+bool writeTrace(const std::string& filename);
+
+/// lock mutex and record the wait if it was held by another thread
+void traceContendedLock(boost::mutex& mutex, const char *name);
+
+/// records its lifetime
+class TraceScope
+{
+private:
+	const char	*name;
+	const char	*category;
+	int			arg;
+	double		start;
+
+public:
+	TraceScope(const char *_name, const char *_category, const int _arg = -1):name(NULL), category(_category), arg(_arg), start(0.0)
+	{
+		if(g_tracing)
+		{
+			name = _name;
+			start = getTime();
+		}
+	}
+
+	~TraceScope()
+	{
+		if(name)traceEvent(name, category, start, arg);
+	}
+};
+
+/// lock mutex, the time spent waiting for another thread shows up in the trace
+inline void traceLock(boost::mutex& mutex, const char *name)
+{
+	if(g_tracing)traceContendedLock(mutex, name);
+	else mutex.lock();
+}
+
+#define TRACE_SCOPE(name, category)				TraceScope trace_scope_(name, category)
+#define TRACE_SCOPE_ARG(name, category, arg)	TraceScope trace_scope_(name, category, arg)
+
+#endif
\ No newline at end of file
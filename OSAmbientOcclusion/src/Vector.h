@@ -12,6 +12,7 @@
 #include <cmath>
 #include <string>
 #include <sstream>
+#include <iostream>
 
 #define EPSILON 0.00001
 
@@ -161,6 +162,10 @@ inline Vector VectorMax(const Vector& a, const Vector& b)
 	return res;
 }
 
+// stream operators, used for scene descriptions
+inline std::ostream& operator << (std::ostream& out, const Vector& v)	{return out<<v.x<<" "<<v.y<<" "<<v.z;}
+inline std::istream& operator >> (std::istream& in, Vector& v)			{in>>v.x>>v.y>>v.z; v.w = 1.0f; return in;}
+
 inline Vector VectorMin(const Vector& a, const Vector& b)
 {
 	Vector res = a;
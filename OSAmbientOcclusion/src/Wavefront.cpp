@@ -0,0 +1,117 @@
+// Object Space Ambient Occlusion Demo Project
+// (c) 2013 by L.Spiegelberg
+// This code may be redistributed or modified for any learning or teaching purposes
+// but not for any commercial uses
+// to gain further license informations please contact me via
+// spiegelb (at) in.tum.de
+
+#include <algorithm>
+#include <cmath>
+
+#include "main.h"
+#include "Wavefront.h"
+
+using namespace std;
+
+/// rays traced per batch, bounds the memory of the ray queue
+static const int wavefront_batch = 1 << 16;
+
+static inline bool compareKeys(const WavefrontRay& a, const WavefrontRay& b)
+{
+	return a.key < b.key;
+}
+
+/// spread lower 9 bits so two zero bits follow each bit
+static inline unsigned int spreadBits(unsigned int v)
+{
+	v &= 0x1ff;
+	v = (v | (v << 16)) & 0x030000ff;
+	v = (v | (v <<  8)) & 0x0300f00f;
+	v = (v | (v <<  4)) & 0x030c30c3;
+	v = (v | (v <<  2)) & 0x09249249;
+
+	return v;
+}
+
+/// morton code of the cell of the origin(cells as large as the ao radius) followed by the direction octant
+static inline unsigned int sortKey(const Vector& origin, const Vector& direction)
+{
+	float inv = 1.0f / g_options.aoRadius;
+
+	unsigned int x = (unsigned int)(int)floor(origin.x * inv);
+	unsigned int y = (unsigned int)(int)floor(origin.y * inv);
+	unsigned int z = (unsigned int)(int)floor(origin.z * inv);
+
+	unsigned int octant = (direction.x < 0.0f ? 1 : 0) | (direction.y < 0.0f ? 2 : 0) | (direction.z < 0.0f ? 4 : 0);
+
+	return (((spreadBits(x) | (spreadBits(y) << 1) | (spreadBits(z) << 2))) << 3) | octant;
+}
+
+/// sort queued rays and trace them, hits are counted per point
+static void traceBatch(vector<WavefrontRay>& queue, const vector<Vector>& points, vector<int>& hits)
+{
+	sort(queue.begin(), queue.end(), compareKeys);
+
+	Ray ray;
+
+	for(vector<WavefrontRay>::const_iterator it = queue.begin(); it != queue.end(); ++it)
+	{
+		ray.origin = points[it->point];
+		ray.direction = it->direction;
+
+		// same test as computeAO
+		if(g_aoAccel->occluded(ray, 0.0001f, g_options.aoRadius))hits[it->point]++;
+	}
+
+	queue.clear();
+}
+
+void wavefrontAO(const vector<Vector>& points, const vector<Vector>& normals, const int samples, vector<float>& occlusion,
+				 WavefrontBuffers& buffers)
+{
+	int count = (int)points.size();
+
+	vector<WavefrontRay>& queue = buffers.queue;
+	queue.clear();
+	queue.reserve(min(wavefront_batch, count * samples));
+
+	vector<int>& hits = buffers.hits;
+	hits.assign(count, 0);
+
+	for(int i = 0; i < count; i++)
+	{
+		const Vector& normal = normals[i];
+		if(normal * normal == 0.0f)continue;
+
+		Vector tangent;
+		Vector binormal;
+		hemisphereBasis(normal, tangent, binormal);
+
+		STATS_ADD(aoRays, samples);
+
+		// generate directions like computeAO
+		for(int s = 0; s < samples; s++)
+		{
+			WavefrontRay ray;
+			ray.direction = random(-1.0f, 1.0f) * tangent + random(-1.0f, 1.0f) * binormal + random(0.0, 1.0f) * normal;
+			ray.direction.normalize();
+			ray.point = i;
+			ray.key = sortKey(points[i], ray.direction);
+
+			queue.push_back(ray);
+
+			if((int)queue.size() >= wavefront_batch)traceBatch(queue, points, hits);
+		}
+	}
+
+	traceBatch(queue, points, hits);
+
+	occlusion.resize(count);
+	for(int i = 0; i < count; i++)occlusion[i] = (float)hits[i] / (float)samples;
+}
+void wavefrontAO(const vector<Vector>& points, const vector<Vector>& normals, const int samples, vector<float>& occlusion)
+{
+	WavefrontBuffers buffers;
+
+	wavefrontAO(points, normals, samples, occlusion, buffers);
+}
\ No newline at end of file
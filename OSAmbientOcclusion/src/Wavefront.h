@@ -0,0 +1,42 @@
+// Object Space Ambient Occlusion Demo Project
+// (c) 2013 by L.Spiegelberg
+// This code may be redistributed or modified for any learning or teaching purposes
+// but not for any commercial uses
+// to gain further license informations please contact me via
+// spiegelb (at) in.tum.de
+
+#ifndef WAVEFRONT_HEADER_
+#define WAVEFRONT_HEADER_
+
+#include <vector>
+
+#include "Vector.h"
+
+// the wavefront tracer generates the ambient occlusion rays of many pixels at once, sorts them by
+// the grid cell of their origin and the octant of their direction and traces them in that order,
+// so consecutive rays walk through the same part of the acceleration structure
+
+/// queued ambient occlusion ray
+struct WavefrontRay
+{
+	unsigned int	key;	// sort key, origin cell and direction octant
+	int				point;	// index of the point the ray belongs to
+	Vector			direction;
+};
+
+/// ray queue and hit counts of wavefrontAO, kept by the caller to trace further points without allocating
+struct WavefrontBuffers
+{
+	std::vector<WavefrontRay>	queue;
+	std::vector<int>			hits;
+};
+
+/// ambient occlusion of all points(pixels without hit have a zero normal), like computeAO per point
+void wavefrontAO(const std::vector<Vector>& points, const std::vector<Vector>& normals, const int samples,
+				 std::vector<float>& occlusion, WavefrontBuffers& buffers);
+
+/// same with buffers of its own
+void wavefrontAO(const std::vector<Vector>& points, const std::vector<Vector>& normals, const int samples,
+				 std::vector<float>& occlusion);
+
+#endif
\ No newline at end of file
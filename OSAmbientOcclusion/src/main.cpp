@@ -6,9 +6,26 @@
 // spiegelb (at) in.tum.de
 
 #include "main.h"
+#include "Distributed.h"
+#include "Benchmark.h"
+#include "Animation.h"
+#include "Progressive.h"
+#include "Pipeline.h"
+#include "ScaledAO.h"
+#include "CompressedTileOutput.h"
+#include "AsyncTileOutput.h"
+#include "Server.h"
+#include "SceneEdit.h"
+#include "Numa.h"
 
 using namespace std;
 
+// size of render window
+int g_width = DEFAULT_WIDTH;
+int g_height = DEFAULT_HEIGHT;
+
+// command line settings
+RenderOptions g_options(DEFAULT_WIDTH, DEFAULT_HEIGHT);
 
 // global image
 Image g_image;
@@ -25,12 +42,18 @@ Image g_invao;
 // final composited image
 Image g_final;
 
+// bent normals, mean unoccluded directions and obscurance of the ambient occlusion rays
+Image g_bentnormals;
+Image g_unoccluded;
+Image g_obscurance;
+
 // any image needs a mutex
 boost::mutex img_mutex;
 boost::mutex norm_mutex;
 boost::mutex ao_mutex;
 boost::mutex invao_mutex;
 boost::mutex final_mutex;
+boost::mutex aoext_mutex; // the further ambient occlusion outputs are always written together
 
 // list of scene objects
 vector<IObject*> g_objects;
@@ -38,93 +61,35 @@ vector<IObject*> g_objects;
 // list of scene lights
 vector<ILight*> g_lights;
 
-// store positions
-// store normals
-class GBuffer
-{
-private:
-	Vector *points;
-	Vector *normals;
-	int width, height;
-public:
-	GBuffer():points(NULL), normals(NULL)	{}
-
-	GBuffer(const int _width, const int _height):width(_width), height(_height)
-	{
-		points = new Vector[width * height];
-		normals = new Vector[width * height];
-	}
-
-	GBuffer(const GBuffer& buf)
-	{
-		width = buf.width;
-		height = buf.height;
-
-		points = new Vector[width * height];
-		normals = new Vector[width * height];
-
-		for(int i = 0; i < width*height; i++)
-		{
-			points[i] = buf.points[i];
-			normals[i] = buf.normals[i];
-		}
-	}
-
-	~GBuffer()
-	{
-		if(points)delete [] points;
-		if(normals)delete [] normals;
-	}
-
-	void operator =		(const GBuffer& buf)
-	{
-		width = buf.width;
-		height = buf.height;
-
-		points = new Vector[width * height];
-		normals = new Vector[width * height];
-
-		for(int i = 0; i < width*height; i++)
-		{
-			points[i] = buf.points[i];
-			normals[i] = buf.normals[i];
-		}
-	}
+GBuffer g_GBuffer;
 
-	Vector getPoint(const int x, const int y)
-	{
-		assert(0 <= x + y * width && x + y *width < width * height);
+// final image in a memory mapped file, only open with --shared-framebuffer
+SharedFramebuffer g_sharedFramebuffer;
 
-		return points[x + y * width];
-	}
+// render cost of each pixel and its false color image, only with --heatmap
+CostMap g_costMap;
+Image g_heatmap;
 
-	Vector getNormal(const int x, const int y)
-	{
-		assert(0 <= x + y * width && x + y *width < width * height);
-
-		return normals[x + y * width];
-	}
+// set by the render thread of the viewer when the frame is done, g_costMap is only read after that
+static bool g_renderDone = false;
+static boost::mutex done_mutex;
 
-	void setPoint(const int x, const int y, const Vector& point)
-	{
-		assert(0 <= x + y * width && x + y *width < width * height);
-		points[x + y * width] = point;
-	}
+// camera
+Camera g_camera;
 
-	void setNormal(const int x, const int y, const Vector& normal)
-	{
-		assert(0 <= x + y * width && x + y *width < width * height);
-		normals[x + y * width] = normal;
-	}
-};
+// acceleration structures, rebuilt whenever the scene changes
+IAccelerator *g_primaryAccel = NULL;
+IAccelerator *g_aoAccel = NULL;
+AnalyticAO *g_analyticAO = NULL;
+SurfelAO *g_surfelAO = NULL;
 
+// lights of finite range sorted into cells
+LightGrid g_lightGrid;
 
-GBuffer g_GBuffer;
+/// events each thread keeps for --trace, older ones are overwritten
+static const int trace_events = 1 << 16;
 
-// camera
-Camera g_camera;
-
-#define MAX_MODES 5
+#define MAX_MODES 9
 // mode
 int mode;
 
@@ -162,6 +127,22 @@ void Draw()
 	{
 		glBindTexture(GL_TEXTURE_2D, g_final.getTexture());
 	}
+	if(mode == 5)
+	{
+		glBindTexture(GL_TEXTURE_2D, g_bentnormals.getTexture());
+	}
+	if(mode == 6)
+	{
+		glBindTexture(GL_TEXTURE_2D, g_unoccluded.getTexture());
+	}
+	if(mode == 7)
+	{
+		glBindTexture(GL_TEXTURE_2D, g_obscurance.getTexture());
+	}
+	if(mode == 8)
+	{
+		glBindTexture(GL_TEXTURE_2D, g_heatmap.getTexture());
+	}
 
 
 	glBegin (GL_QUADS);
@@ -191,8 +172,13 @@ Color shade(const Ray& r, const float fDistance, const Vector& normal, const Col
 
 	if(!g_lights.empty())
 	{
+		// only lights that may reach the point
+		if(g_options.lightCulling)return g_lightGrid.shade(r, fDistance, normal, color);
+
 		res = Color::black;
 
+		STATS_ADD(lightEvaluations, g_lights.size());
+
 		for(vector<ILight*>::iterator it = g_lights.begin();
 			it != g_lights.end(); ++it)
 		{
@@ -205,45 +191,26 @@ Color shade(const Ray& r, const float fDistance, const Vector& normal, const Col
 
 bool intersectObjects(const Ray& r, float& fDistance, Vector& normal, Color& color)
 {
-	// simply intersect with all objects...
-	if(g_objects.empty())return false;
-
-	float fLastDistance = 99999.9f;
-	color = Color::white;
-	bool intersection = false;
-
-	for(vector<IObject*>::iterator it = g_objects.begin();
-		it != g_objects.end(); ++it)
-	{
-		// temp variables
-		Vector _normal;
-		Color _color;
-		if((*it)->intersect(r, fDistance, _normal, _color))
-		{
-			intersection = true;
+	return g_primaryAccel->intersect(r, fDistance, normal, color);
+}
 
-			// nearer?
-			if(fDistance < fLastDistance)
-			{
-				fLastDistance = fDistance;
-				color = _color;
-				normal = _normal;
-			}
-		}
-	}
+/// shaded color of the nearest hit, object is NULL if nothing was hit
+static Color traceNearest(const Ray& r, float& fDistance, Vector& normal, IObject *&object)
+{
+	Color color;
 
-	fDistance = fLastDistance;
+	// shade
+	if(g_primaryAccel->intersectObject(r, fDistance, normal, color, object))color = shade(r, fDistance, normal, color);
 
-	return intersection;
+	return color;
 }
 
 Color traceRay(const Ray& r, Vector& normal, Vector& point)
 {
-	Color color;
 	float fDistance;
+	IObject *object;
 
-	// shade
-	if(intersectObjects(r, fDistance, normal, color))color = shade(r, fDistance, normal, color);
+	Color color = traceNearest(r, fDistance, normal, object);
 
 	// calc point
 	point = r.origin + fDistance * r.direction;
@@ -251,8 +218,20 @@ Color traceRay(const Ray& r, Vector& normal, Vector& point)
 	return color;
 }
 
-// for antialiasing
-Color traceGrid(const int x, const int y, const int grid_size)
+Color traceGBuffer(GBuffer& gbuffer, const int x, const int y, const Ray& r, Vector& normal)
+{
+	float fDistance;
+	IObject *object;
+
+	Color color = traceNearest(r, fDistance, normal, object);
+
+	gbuffer.setSample(x, y, fDistance, normal, object ? object->getId() : GBuffer::no_object);
+
+	return color;
+}
+
+/// antialiasing for any grid size
+static Color traceGridGeneric(const int x, const int y, const int grid_size)
 {
 	float fX = (float)x;
 	float fY = (float)y;
@@ -265,6 +244,8 @@ Color traceGrid(const int x, const int y, const int grid_size)
 	Vector point;
 	Ray ray;
 
+	STATS_ADD(aaRays, grid_size * grid_size);
+
 	for(int i = 0; i < grid_size; i++)
 		for(int j = 0; j < grid_size; j++)
 		{
@@ -278,33 +259,101 @@ Color traceGrid(const int x, const int y, const int grid_size)
 	return col;
 }
 
+/// antialiasing with a grid size known at compile time. the sub pixel positions are kept on the stack and
+/// all loops have fixed trip counts, the result is exactly the one of traceGridGeneric
+template<int N> static Color traceGridFixed(const int x, const int y)
+{
+	const float fd = 1.0f / (float)N;
+
+	float fX[N];
+	float fY[N];
+	for(int i = 0; i < N; i++)
+	{
+		fX[i] = (float)x - 0.5f + fd * i;
+		fY[i] = (float)y - 0.5f + fd * i;
+	}
+
+	Color col = Color::black;
+	Vector normal;
+	Vector point;
+
+	STATS_ADD(aaRays, N * N);
+
+	for(int i = 0; i < N; i++)
+		for(int j = 0; j < N; j++)col = col + traceRay(g_camera.getRay(fX[i], fY[j]), normal, point);
+
+	return col / (float)(N * N);
+}
+
+// for antialiasing, common grid sizes use a specialized kernel
+Color traceGrid(const int x, const int y, const int grid_size)
+{
+	switch(grid_size)
+	{
+	case 1:	return traceGridFixed<1>(x, y);
+	case 2:	return traceGridFixed<2>(x, y);
+	case 3:	return traceGridFixed<3>(x, y);
+	case 4:	return traceGridFixed<4>(x, y);
+	case 5:	return traceGridFixed<5>(x, y);
+	default:	return traceGridGeneric(x, y, grid_size);
+	}
+}
+
+/// direction mapped from [-1, 1] to a color
+static inline Color directionColor(const Vector& v)
+{
+	return Color((v.x + 1.0f) / 2.0f, (v.y + 1.0f) / 2.0f, (v.z + 1.0f) / 2.0f);
+}
+
+/// raytrace a single column of the image
+void RaytraceColumn(const int x, const int /*thread*/)
+{
+	TRACE_SCOPE_ARG("raytrace column", "raytrace", x);
+
+	for(int y = 0; y < g_height; y++)
+	{
+		CostProbe probe = g_costMap.probe();
+
+		// trace ray
+		Ray ray = g_camera.getRay(x, y);
+		Vector normal;
+
+		STATS_ADD(primaryRays, 1);
+		STATS_ADD(pixels, 1);
+
+		// store in buffer
+		traceGBuffer(g_GBuffer, x, y, ray, normal);
+
+		Color col = traceGrid(x, y, g_options.aaGrid);
+
+		g_costMap.add(x, y, probe);
+
+		// mutexes
+		traceLock(norm_mutex, "norm_mutex");
+		g_normals.setPixel(x, y, directionColor(normal));
+		norm_mutex.unlock();
+		traceLock(img_mutex, "img_mutex");			
+		g_image.setPixel(x, y, col);
+		img_mutex.unlock();
+	}
+}
+
 void Raytrace()
 {
+	STATS_TIMER(PASS_RAYTRACE);
+	TRACE_SCOPE("raytrace", "pass");
+
+	g_GBuffer.setCamera(g_camera, 0, 0);
+
 	// raytrace...
-	for(int x = 0; x < g_width; x++)
-		for(int y = 0; y < g_height; y++)
-		{
-			// trace ray
-			Ray ray = g_camera.getRay(x, y);
-			Vector normal;
-			Vector point;
+	parallelFor(g_width, g_options.threads, RaytraceColumn);
 
-			Color col = traceRay(ray, normal, point);
-			
-			// store in buffer
-			g_GBuffer.setNormal(x, y, normal);
-			g_GBuffer.setPoint(x, y, point);
-
-			col = traceGrid(x, y, 5);
-
-			// mutexes
-			norm_mutex.lock();
-			g_normals.setPixel(x, y, Color((normal.x + 1.0f) / 2.0f, (normal.y + 1.0f) / 2.0f, (normal.z + 1.0f) / 2.0f));
-			norm_mutex.unlock();
-			img_mutex.lock();			
-			g_image.setPixel(x, y, col);
-			img_mutex.unlock();
-		}
+	DepthPass();
+}
+
+void DepthPass()
+{
+	TRACE_SCOPE("depth", "pass");
 
 	// generate depth picture
 	float fminZ = 99999.9f, fmaxZ = -99999.9f;
@@ -316,7 +365,7 @@ void Raytrace()
 		}
 	float fDepth = fmaxZ - fminZ; // scale factor
 
-	norm_mutex.lock();
+	traceLock(norm_mutex, "norm_mutex");
 	for(int x = 0; x < g_width; x++)
 		for(int y = 0; y < g_height; y++)
 		{
@@ -326,7 +375,7 @@ void Raytrace()
 	norm_mutex.unlock();
 }
 
-void createScene()
+void setupCamera()
 {
 	//// some new things
 	/////fov = 3.14159 / 3.2
@@ -335,6 +384,11 @@ void createScene()
 	Vector upDir	= Vector(0, 1, 0);
 	g_camera.setPositionAndLookAt(3.14159 / 3.2,
 		camPos, lookAt, upDir, g_width, g_height);
+}
+
+void createScene()
+{
+	setupCamera();
 
 	// add some spheres
 
@@ -362,6 +416,16 @@ void createScene()
 
 void deleteScene()
 {
+	delete g_primaryAccel;
+	delete g_aoAccel;
+	g_primaryAccel = g_aoAccel = NULL;
+
+	delete g_analyticAO;
+	g_analyticAO = NULL;
+
+	delete g_surfelAO;
+	g_surfelAO = NULL;
+
 	// delete memory
 	if(!g_objects.empty())
 		for(vector<IObject*>::iterator it = g_objects.begin();
@@ -385,6 +449,45 @@ void deleteScene()
 	g_lights.clear();
 }
 
+bool buildAccelerators()
+{
+	delete g_primaryAccel;
+	delete g_aoAccel;
+
+	// cells about as large as the ambient occlusion rays are long
+	float cellSize = g_options.aoRadius * g_options.gridCellScale;
+
+	// objects are identified by their index, e.g. in the GBuffer
+	for(unsigned int i = 0; i < g_objects.size(); i++)g_objects[i]->setId((int)i);
+
+	g_primaryAccel = createAccelerator(g_options.primaryAccel, g_objects, cellSize);
+	g_aoAccel = createAccelerator(g_options.aoAccel, g_objects, cellSize);
+
+	g_lightGrid.build(g_lights);
+
+	if(!g_primaryAccel || !g_aoAccel)
+	{
+		cout<<"unknown acceleration structure "<<(g_primaryAccel ? g_options.aoAccel : g_options.primaryAccel)<<endl;
+		return false;
+	}
+
+	// objects without closed form are traced with the ao acceleration structure
+	if(g_options.aoMethod == "analytic")
+	{
+		if(!g_analyticAO)g_analyticAO = new AnalyticAO();
+		if(!g_analyticAO->build(g_objects, g_options.aoAccel, g_options.aoRadius, cellSize))return false;
+	}
+
+	// surfels follow the objects, so they are made again after edits
+	if(g_options.aoMethod == "surfels")
+	{
+		if(!g_surfelAO)g_surfelAO = new SurfelAO();
+		g_surfelAO->build(g_objects, g_options.aoRadius, g_options.surfelSize, g_options.surfelError);
+	}
+
+	return true;
+}
+
 // rejection sampling
 Vector getHemisphereVector(const Vector& normal)
 {
@@ -407,161 +510,801 @@ Vector getHemisphereVector(const Vector& normal)
 	return Vector();
 }
 
+void hemisphereBasis(const Vector& normal, Vector& tangent, Vector& binormal)
+{
+	static const float epsilon = 0.0001f;
+
+	// construct tangent and binormal
+	// if x, y != 0 choose t = (-n2 n1 0)^T
+	// else t = (0 -n3 n2)^T
+	if(abs(normal.x) > epsilon || abs(normal.y) > epsilon)
+	{
+		tangent = Vector(-normal.y, normal.x, 0.0f);
+	}
+	else
+	{
+		tangent = Vector(0.0f, -normal.z, normal.y);
+	}
+	tangent.normalize();
+
+	// use cross product to determine binormal
+	binormal = tangent.crossproduct(normal);
+
+	// normalize
+	tangent.normalize();
+	binormal.normalize();
+
+	// some assertions
+	assert(normal * tangent < epsilon);
+	assert(normal * binormal < epsilon);
+	assert(tangent * binormal < epsilon);
+}
+
+/// ambient occlusion for any sample count
+static float computeAOGeneric(const Vector& point, const Vector& normal, const int samples)
+{
+	static const float epsilon = 0.0001f;
+
+	// calc a basis for the local hemisphere
+	Vector tangent;
+	Vector binormal;
+	hemisphereBasis(normal, tangent, binormal);
+
+	// shoot random rays
+	Ray kernel_ray(point, Vector()); // init with position
+
+	STATS_ADD(aoRays, samples);
+
+	// now perform AO
+	float occlusion_factor = 0.0;
+	for(int i = 0; i < samples; i++)
+	{
+		// construct local random ray, through basis
+		// note that we use a hemisphere, therefore the random value for the normal is in [0, 1]
+		Vector v = random(-1.0f, 1.0f) * tangent + random(-1.0f, 1.0f) * binormal + random(0.0, 1.0f) * normal;
+		v.normalize();
+			
+		kernel_ray.direction = v;
+
+		// any object in range occludes, the surface itself is excluded by the epsilon
+		if(g_aoAccel->occluded(kernel_ray, epsilon, g_options.aoRadius))occlusion_factor += 1.0; // simply add(maybe later account light better)
+	}
+
+	return occlusion_factor / (float)samples;
+}
+
+/// ambient occlusion with a sample count known at compile time. all directions are drawn into a stack
+/// array before the rays are traced, in the same order as computeAOGeneric, so the result is the same
+template<int SAMPLES> static float computeAOFixed(const Vector& point, const Vector& normal)
+{
+	static const float epsilon = 0.0001f;
+
+	Vector tangent;
+	Vector binormal;
+	hemisphereBasis(normal, tangent, binormal);
+
+	Vector directions[SAMPLES];
+	for(int i = 0; i < SAMPLES; i++)
+	{
+		Vector v = random(-1.0f, 1.0f) * tangent + random(-1.0f, 1.0f) * binormal + random(0.0, 1.0f) * normal;
+		v.normalize();
+
+		directions[i] = v;
+	}
+
+	STATS_ADD(aoRays, SAMPLES);
+
+	Ray kernel_ray(point, Vector());
+	int occluded = 0;
+
+	for(int i = 0; i < SAMPLES; i++)
+	{
+		kernel_ray.direction = directions[i];
+		if(g_aoAccel->occluded(kernel_ray, epsilon, g_options.aoRadius))occluded++;
+	}
+
+	return (float)occluded / (float)SAMPLES;
+}
+
+// common sample counts use a specialized kernel
+float computeAO(const Vector& point, const Vector& normal, const int samples)
+{
+	if(g_analyticAO)return g_analyticAO->occlusion(point, normal, samples);
+	if(g_surfelAO)return g_surfelAO->occlusion(point, normal);
+
+	switch(samples)
+	{
+	case 8:		return computeAOFixed<8>(point, normal);
+	case 16:	return computeAOFixed<16>(point, normal);
+	case 32:	return computeAOFixed<32>(point, normal);
+	case 64:	return computeAOFixed<64>(point, normal);
+	case 128:	return computeAOFixed<128>(point, normal);
+	case 256:	return computeAOFixed<256>(point, normal);
+	default:	return computeAOGeneric(point, normal, samples);
+	}
+}
+
+AOSample computeAOSample(const Vector& point, const Vector& normal, const int samples)
+{
+	static const float epsilon = 0.0001f;
+
+	Vector tangent;
+	Vector binormal;
+	hemisphereBasis(normal, tangent, binormal);
+
+	Ray kernel_ray(point, Vector());
+
+	STATS_ADD(aoRays, samples);
+
+	int occluded = 0;
+	float obscurance = 0.0f;
+	Vector unoccluded(0.0f, 0.0f, 0.0f);
+
+	for(int i = 0; i < samples; i++)
+	{
+		// same directions as computeAO
+		Vector v = random(-1.0f, 1.0f) * tangent + random(-1.0f, 1.0f) * binormal + random(0.0, 1.0f) * normal;
+		v.normalize();
+
+		kernel_ray.direction = v;
+
+		// the nearest hit gives the distance for the obscurance
+		float fDistance;
+		if(g_aoAccel->hitDistance(kernel_ray, epsilon, g_options.aoRadius, fDistance))
+		{
+			occluded++;
+			obscurance += 1.0f - fDistance / g_options.aoRadius;
+		}
+		else unoccluded = unoccluded + v;
+	}
+
+	AOSample res;
+	res.occlusion = (float)occluded / (float)samples;
+	res.obscurance = obscurance / (float)samples;
+	res.unoccluded = unoccluded / (float)samples;
+
+	res.bentNormal = normal;
+	if(occluded < samples)
+	{
+		res.bentNormal = unoccluded;
+		res.bentNormal.normalize();
+	}
+
+	return res;
+}
+
+void setAOPixel(const int x, const int y, const AOSample& sample)
+{
+	g_aopass.setPixel(x, y, Color(sample.occlusion, sample.occlusion, sample.occlusion));
+	g_bentnormals.setPixel(x, y, directionColor(sample.bentNormal));
+	g_unoccluded.setPixel(x, y, directionColor(sample.unoccluded));
+	g_obscurance.setPixel(x, y, Color(sample.obscurance, sample.obscurance, sample.obscurance));
+}
+
 Color traceAO(const Ray& r)
 {
 	Color color = Color::black;
 
-	// shoot randomly oriented rays from the hemisphere...
-	int kernel_size = 256; // sample count
 	float fDistance;
 	Vector normal;
 	Color col; //received color, dummy
 
+	STATS_ADD(primaryRays, 1);
+
 	// intersection?
 	if(intersectObjects(r, fDistance, normal, col))
 	{
-		// perform AO
-		static const float epsilon = 0.0001f;
-
 		// determine intersection position
 		Vector point = r.origin + (r.direction * fDistance);
 
-		// calc a basis for the local hemisphere
-		Vector tangent;
-		Vector binormal;
-		
-		// construct tangent and binormal
-		// if x, y != 0 choose t = (-n2 n1 0)^T
-		// else t = (0 -n3 n2)^T
-		if(abs(normal.x) > epsilon || abs(normal.y) > epsilon)
-		{
-			tangent = Vector(-normal.y, normal.x, 0.0f);
-		}
-		else
-		{
-			tangent = Vector(0.0f, -normal.z, normal.y);
-		}
-		tangent.normalize();
+		// shoot randomly oriented rays from the hemisphere...
+		float occlusion_factor = computeAO(point, normal, g_options.aoSamples);
+		color = Color(occlusion_factor, occlusion_factor, occlusion_factor);
+	}
+
+	return color;
+}
 
-		// use cross product to determine binormal
-		binormal = tangent.crossproduct(normal);
+// columns of the ambient occlusion pass, one per thread and kept over frames
+static vector<vector<Color> > g_aoColumns;
+static vector<vector<AOSample> > g_aoSampleColumns;
+static vector<vector<float> > g_scaledColumns;
 
-		// normalize
-		tangent.normalize();
-		binormal.normalize();
+// blocks of the reduced resolution ambient occlusion, kept over frames
+static ScaledAO g_scaledAO;
 
-		// some assertions
-		assert(normal * tangent < epsilon);
-		assert(normal * binormal < epsilon);
-		assert(tangent * binormal < epsilon);
+/// all ambient occlusion outputs of a single column of the image
+void AmbientOcclusionOutputsColumn(const int x, const int thread)
+{
+	vector<AOSample>& column = g_aoSampleColumns[thread];
+	column.assign(g_height, AOSample());
 
-		// shoot random rays
-		Ray kernel_ray(point, Vector()); // init with position
+	for(int y = 0; y < g_height; y++)
+	{
+		CostProbe probe = g_costMap.probe();
 
-		// dummies
-		float kernel_fdist;
-		Vector kernel_normal;
-		Color kernel_color;
+		Ray ray = g_camera.getRay(x, y);
 
-		// now perform AO
-		float occlusion_factor = 0.0;
-		for(int i = 0; i < kernel_size; i++)
-		{
-			// construct local random ray, through basis
-			// note that we use a hemisphere, therefore the random value for the normal is in [0, 1]
-			Vector v = random(-1.0f, 1.0f) * tangent + random(-1.0f, 1.0f) * binormal + random(0.0, 1.0f) * normal;
-			v.normalize();
-				
-			kernel_ray.direction = v;
-
-			// intersect with scene
-			if(intersectObjects(kernel_ray, kernel_fdist, kernel_normal, kernel_color))
-			{
-				assert(kernel_fdist >= 0.0);
-				
-				// range check
-				if(kernel_fdist < 0.40f && kernel_fdist > 0.0001f)occlusion_factor += 1.0; // simply add(maybe later account light better)
-			}
-		}
+		float fDistance;
+		Vector normal;
+		Color col;
 
-		occlusion_factor /= (float)kernel_size;
-		color = Color(occlusion_factor, occlusion_factor, occlusion_factor);
+		STATS_ADD(primaryRays, 1);
+
+		// pixels without hit keep zero directions
+		if(intersectObjects(ray, fDistance, normal, col))column[y] = computeAOSample(ray.origin + ray.direction * fDistance, normal, g_options.aoSamples);
+
+		g_costMap.add(x, y, probe);
 	}
 
-	return color;
+	traceLock(ao_mutex, "ao_mutex");
+	traceLock(aoext_mutex, "aoext_mutex");
+	for(int y = 0; y < g_height; y++)setAOPixel(x, y, column[y]);
+	aoext_mutex.unlock();
+	ao_mutex.unlock();
+}
+
+/// ambient occlusion of a single column of the image
+void AmbientOcclusionColumn(const int x, const int thread)
+{
+	TRACE_SCOPE_ARG("ao column", "ao", x);
+
+	if(g_options.aoOutputs)
+	{
+		AmbientOcclusionOutputsColumn(x, thread);
+		return;
+	}
+
+	// trace whole column first, so other threads and the display are not blocked meanwhile
+	vector<Color>& column = g_aoColumns[thread];
+	column.resize(g_height);
+
+	for(int y = 0; y < g_height; y++)
+	{
+		CostProbe probe = g_costMap.probe();
+
+		// trace ray
+		Ray ray = g_camera.getRay(x, y);
+
+		column[y] = traceAO(ray);
+
+		g_costMap.add(x, y, probe);
+	}
+
+	traceLock(ao_mutex, "ao_mutex");
+	for(int y = 0; y < g_height; y++)g_aopass.setPixel(x, y, column[y]);
+	ao_mutex.unlock();
+}
+
+/// ambient occlusion of a column of blocks, the cost is spread over the pixels of the blocks
+void ScaledAOBlockColumn(ScaledAO& scaled, const int bx, const int thread)
+{
+	CostProbe probe = g_costMap.probe();
+
+	scaled.computeColumn(bx, thread);
+
+	int x = bx * g_options.aoScale;
+	g_costMap.addTile(Tile(x, 0, min(g_options.aoScale, g_width - x), g_height), probe);
+}
+
+/// upsampled ambient occlusion of a single column of the image
+void ScaledAOColumn(ScaledAO& scaled, const int x, const int thread)
+{
+	CostProbe probe = g_costMap.probe();
+
+	vector<float>& column = g_scaledColumns[thread];
+	scaled.upsampleColumn(x, column);
+
+	g_costMap.addTile(Tile(x, 0, 1, g_height), probe);
+
+	traceLock(ao_mutex, "ao_mutex");
+	for(int y = 0; y < g_height; y++)g_aopass.setPixel(x, y, Color(column[y], column[y], column[y]));
+	ao_mutex.unlock();
 }
 
 void AmbientOcclusionPass()
 {
+	STATS_TIMER(PASS_AO);
+	TRACE_SCOPE("ao", "pass");
+
+	if((int)g_aoColumns.size() < g_options.threads)
+	{
+		g_aoColumns.resize(g_options.threads);
+		g_aoSampleColumns.resize(g_options.threads);
+		g_scaledColumns.resize(g_options.threads);
+	}
+
+	// blocks of the GBuffer, the raytrace pass has to be done
+	if(g_options.aoScale > 1)
+	{
+		g_scaledAO.setup(g_GBuffer, Tile(0, 0, g_width, g_height), g_options.aoScale);
+
+		parallelFor(g_scaledAO.getBlocksX(), g_options.threads, boost::bind(ScaledAOBlockColumn, boost::ref(g_scaledAO), _1, _2));
+		parallelFor(g_width, g_options.threads, boost::bind(ScaledAOColumn, boost::ref(g_scaledAO), _1, _2));
+
+		return;
+	}
+
 	// raytrace...
-	for(int x = 0; x < g_width; x++)
+	parallelFor(g_width, g_options.threads, AmbientOcclusionColumn);
+}
+
+/// clear the tiles owned by thread(see PipelinedRender), so their pages are placed on its NUMA node
+static void clearOwnedTiles(const vector<Image*>& images, const int thread)
+{
+	vector<Tile> tiles = generateTiles(g_width, g_height, g_options.tileSize);
+
+	for(unsigned int i = 0; i < tiles.size(); i++)
 	{
-		ao_mutex.lock();
-		
-		for(int y = 0; y < g_height; y++)
-		{
-			// trace ray
-			Ray ray = g_camera.getRay(x, y);
+		if(blockOwner((int)i, (int)tiles.size(), g_options.threads) != thread)continue;
 
-			Color col = traceAO(ray);
-			
-			g_aopass.setPixel(x, y, col);
-			
-		}
-		
-		ao_mutex.unlock();
+		for(unsigned int j = 0; j < images.size(); j++)images[j]->clear(tiles[i]);
+		g_GBuffer.clear(tiles[i]);
+	}
+}
+
+void createImages(const int width, const int height)
+{
+	g_width = width;
+	g_height = height;
+
+	vector<Image*> images;
+	images.push_back(&g_image);
+	images.push_back(&g_normals);
+	images.push_back(&g_aopass);
+	images.push_back(&g_invao);
+	images.push_back(&g_final);
+
+	if(g_options.aoOutputs)
+	{
+		images.push_back(&g_bentnormals);
+		images.push_back(&g_unoccluded);
+		images.push_back(&g_obscurance);
 	}
+
+	// costs of the new image
+	if(!g_options.heatmap.empty())g_costMap.create(g_width, g_height);
+
+	// pages are first touched by the pinned threads rendering the tiles
+	if(g_options.numa && g_options.threads > 1)
+	{
+		for(unsigned int i = 0; i < images.size(); i++)images[i]->resize(g_width, g_height);
+		g_GBuffer.resize(g_width, g_height);
+
+		ThreadPool::instance().run(g_options.threads, boost::bind(clearOwnedTiles, boost::cref(images), _1));
+
+		return;
+	}
+
+	for(unsigned int i = 0; i < images.size(); i++)images[i]->create(g_width, g_height);
+
+	// set up GBuffer
+	g_GBuffer.create(g_width, g_height);
+}
+
+/// render thread of the viewer, marks the frame as done afterwards
+static void RenderThread()
+{
+	if(g_options.progressive)RenderProgressive();
+	else RenderMain();
+
+	done_mutex.lock();
+	g_renderDone = true;
+	done_mutex.unlock();
 }
 
 /// own render thread
 void RenderMain()
 {
+	// passes overlap tile by tile
+	if(g_options.pipeline)
+	{
+		RenderPipelined();
+		return;
+	}
+
+	STATS_TIMER(PASS_FRAME);
+	TRACE_SCOPE("frame", "frame");
+
 	// raytrace Image
 	Raytrace();
 	
 	// perform AmbientOcclusion pass
 	AmbientOcclusionPass();
 
-	
 	// composite images...
+	CompositePass();
+}
 
+void CompositePass()
+{
 	// blur
-	invao_mutex.lock();
-	g_invao.copyFrom(g_aopass);
-	g_invao.blur();
-	g_invao.invert();
-	// uncomment to get darker
-	//g_invao.normalize();
-	invao_mutex.unlock();
+	{
+		STATS_TIMER(PASS_BLUR);
+		TRACE_SCOPE("blur", "pass");
+
+		traceLock(invao_mutex, "invao_mutex");
+		g_invao.copyFrom(g_aopass);
+		g_invao.blur();
+		g_invao.invert();
+		// uncomment to get darker
+		//g_invao.normalize();
+		invao_mutex.unlock();
+	}
+
+	// composite
+	{
+		STATS_TIMER(PASS_COMPOSITE);
+		TRACE_SCOPE("composite", "pass");
+
+		traceLock(final_mutex, "final_mutex");
+		g_sharedFramebuffer.beginTile(Tile(0, 0, g_width, g_height));
+		g_final.copyFrom(g_image);
+		g_final.multiply(g_invao);
+		g_sharedFramebuffer.publishTile(Tile(0, 0, g_width, g_height));
+		final_mutex.unlock();
+	}
+
+	g_sharedFramebuffer.publishFrame(g_GBuffer);
+}
+
+void TraceTile(const Tile& tile, TileBuffers& buffers)
+{
+	// the blur needs a border of ambient occlusion values around the tile
+	const int border = Image::blurSize() / 2;
+
+	buffers.resize(tile.width, tile.height, border);
+
+	// raytrace tile
+	{
+		STATS_TIMER(PASS_RAYTRACE);
+		TRACE_SCOPE("raytrace tile", "raytrace");
+
+		buffers.gbuffer.setCamera(g_camera, tile.x, tile.y);
+
+		for(int x = 0; x < tile.width; x++)
+			for(int y = 0; y < tile.height; y++)
+			{
+				// trace ray
+				Ray ray = g_camera.getRay(tile.x + x, tile.y + y);
+				Vector normal;
+
+				STATS_ADD(primaryRays, 1);
+				STATS_ADD(pixels, 1);
+
+				// store in buffer
+				traceGBuffer(buffers.gbuffer, x, y, ray, normal);
+
+				buffers.image.setPixel(x, y, traceGrid(tile.x + x, tile.y + y, g_options.aaGrid));
+			}
+	}
+
+	// perform AmbientOcclusion pass, border pixels outside of the image are
+	// wrapped around like in Image::blur so tiles fit seamlessly together
+	STATS_TIMER(PASS_AO);
+	TRACE_SCOPE("ao tile", "ao");
+
+	for(int x = 0; x < tile.width + 2 * border; x++)
+		for(int y = 0; y < tile.height + 2 * border; y++)
+		{
+			int px = ((tile.x + x - border) % g_width + g_width) % g_width;
+			int py = ((tile.y + y - border) % g_height + g_height) % g_height;
+
+			Ray ray = g_camera.getRay(px, py);
+
+			buffers.aopass.setPixel(x, y, traceAO(ray));
+		}
+}
+
+void CompositeTile(const Tile& tile, TileBuffers& buffers)
+{
+	const int border = Image::blurSize() / 2;
+
+	// blur & invert
+	{
+		STATS_TIMER(PASS_BLUR);
+		TRACE_SCOPE("blur tile", "blur");
+
+		buffers.invao.blurFrom(buffers.aopass, border, border, 0, 0, tile.width, tile.height);
+		buffers.invao.invert();
+	}
 
 	// composite
-	final_mutex.lock();
-	g_final.copyFrom(g_image);
-	g_final.multiply(g_invao);
-	final_mutex.unlock();
+	STATS_TIMER(PASS_COMPOSITE);
+	TRACE_SCOPE("composite tile", "composite");
+
+	for(int x = 0; x < tile.width; x++)
+		for(int y = 0; y < tile.height; y++)
+		{
+			buffers.final.setPixel(x, y, buffers.image.getPixel(x, y) * buffers.invao.getPixel(x, y));
+		}
+}
+
+/// state of a tiled render shared by the render threads
+class TiledRender
+{
+private:
+	const vector<Tile>&	tiles;
+	ITileOutput&		output;
+
+	/// one working set per thread
+	TileBuffers			*buffers;
+
+	boost::mutex		output_mutex;
+	int					finished;
+
+public:
+	TiledRender(const vector<Tile>& _tiles, ITileOutput& _output):tiles(_tiles), output(_output), finished(0)
+	{
+		buffers = new TileBuffers[g_options.threads];
+	}
+
+	~TiledRender()
+	{
+		delete [] buffers;
+	}
+
+	void renderTile(const int index, const int thread)
+	{
+		TRACE_SCOPE_ARG("tile", "tile", index);
+
+		TileBuffers& buf = buffers[thread];
+
+		TraceTile(tiles[index], buf);
+		CompositeTile(tiles[index], buf);
+
+		traceLock(output_mutex, "output_mutex");
+		output.writeTile(tiles[index], buf.final);
+		finished++;
+		cout<<"\rtile "<<finished<<"/"<<tiles.size()<<flush;
+		output_mutex.unlock();
+	}
+};
+
+/// render image tile by tile, finished tiles are passed to output
+/// so peak memory only depends on the tile size. returns false if the output failed
+bool RenderTiled(ITileOutput& output)
+{
+	STATS_TIMER(PASS_FRAME);
+	TRACE_SCOPE("frame", "frame");
+
+	vector<Tile> tiles = generateTiles(g_width, g_height, g_options.tileSize);
+
+	if(!output.begin(g_width, g_height))return false;
+
+	TiledRender render(tiles, output);
+
+	parallelFor((int)tiles.size(), g_options.threads, boost::bind(&TiledRender::renderTile, &render, _1, _2));
+
+	cout<<endl;
+
+	return output.end();
+}
+
+/// print or write statistics as requested on the command line
+void ReportStats()
+{
+	// timeline of the whole run
+	if(!g_options.trace.empty())writeTrace(g_options.trace);
+
+	RenderStats stats = gatherStats();
+
+	if(g_options.stats)printStats(cout, stats);
+
+	if(!g_options.statsFile.empty())
+	{
+		ofstream file(g_options.statsFile.c_str());
+		writeStatsJSON(file, stats);
+	}
 }
 
 int main(int argc, char * argv[])
 {
-	// set up images
-	g_image.create(g_width, g_height);
-	g_normals.create(g_width, g_height);
-	g_aopass.create(g_width, g_height);
-	g_invao.create(g_width, g_height);
-	g_final.create(g_width, g_height);
+	if(!parseOptions(argc, argv, g_options))
+	{
+		printUsage(argv[0]);
+		return 1;
+	}
 
-	// set up GBuffer
-	g_GBuffer = GBuffer(g_width, g_height);
+	if(!g_options.threads)g_options.threads = max(1, (int)boost::thread::hardware_concurrency());
+
+	// read by the blur of every image, fixed before any thread renders
+	Image::blurSize() = g_options.blurSize;
+
+	// threads start recording with their first event
+	if(!g_options.trace.empty())
+	{
+		startTrace(trace_events);
+		setTraceThreadName("main");
+	}
+
+	// memory bandwidth of the NUMA nodes, needs no scene or images
+	if(g_options.benchNuma)return RunBandwidthBenchmark() ? 0 : 1;
+
+	// compressed tile files are checked by converting them back to PPM
+	if(!g_options.decode.empty())
+	{
+		Image img;
+		return readCompressedTiles(g_options.decode, img) && writePPM(g_options.output, img) ? 0 : 1;
+	}
+
+	// render threads stay on their cores, so the memory they place stays local
+	if(g_options.numa)ThreadPool::instance().setAffinity(NumaTopology::instance().workerCpus(g_options.threads));
+
+	g_width = g_options.width;
+	g_height = g_options.height;
+
+	// set up images, tiled and distributed rendering only need buffers for a single tile
+	if(!g_options.tiled && !g_options.coordinatorPort && g_options.worker.empty() && g_options.benchmark.empty())
+	{
+		createImages(g_width, g_height);
+	}
+
+	// render straight into memory other processes can read
+	if(!g_options.sharedFramebuffer.empty())
+	{
+		int layers;
+		if(!parseSharedLayers(g_options.sharedLayers, layers))
+		{
+			cout<<"unknown shared framebuffer layer"<<endl;
+			return 1;
+		}
+
+		if(!g_sharedFramebuffer.open(g_options.sharedFramebuffer, g_width, g_height, g_options.tileSize, layers, g_final, g_aopass))return 1;
+	}
+
+	// metrics of the heatmaps, rays and tests come from the render statistics
+	vector<CostMetric> heatmaps;
+	for(unsigned int i = 0; i < g_options.heatmap.size(); i++)
+	{
+		CostMetric metric;
+		if(!parseCostMetric(g_options.heatmap[i], metric))
+		{
+			cout<<"unknown heatmap metric "<<g_options.heatmap[i]<<", use time, rays or tests"<<endl;
+			return 1;
+		}
+
+#ifndef OSAO_STATS
+		if(metric != COST_TIME)
+		{
+			cout<<"rays and intersection tests are only counted if compiled with OSAO_STATS"<<endl;
+			return 1;
+		}
+#endif
+		heatmaps.push_back(metric);
+	}
 
 	// start mode is 0
 	mode = 0;
 
 	srand((unsigned)time(0));
 
+	// benchmark creates its own scenes
+	if(!g_options.benchmark.empty())
+	{
+		bool success = RunBenchmark(g_options.benchmark);
+
+		deleteScene();
+
+		return success ? 0 : 1;
+	}
+
+	// workers get their scene from the coordinator
+	if(!g_options.worker.empty())
+	{
+		bool success = RunWorker(g_options.worker);
+
+		ReportStats();
+		deleteScene();
+
+		return success ? 0 : 1;
+	}
+
 	// define some scene objects
 	createScene();
+
+	if(!buildAccelerators())
+	{
+		deleteScene();
+		return 1;
+	}
+
+	// edits render only the pixels they affect
+	if(g_options.benchEdits)
+	{
+		bool success = RunEditBenchmark(g_options.benchEdits);
+
+		ReportStats();
+		deleteScene();
+
+		return success ? 0 : 1;
+	}
+
+	// scene stays loaded for all requests
+	if(!g_options.server.empty())
+	{
+		bool success = RunServer(g_options.server);
+
+		ReportStats();
+		deleteScene();
+
+		return success ? 0 : 1;
+	}
+
+	// camera flight through the scene
+	if(!g_options.animation.empty())
+	{
+		bool success = RunAnimation(g_options.animation);
+
+		ReportStats();
+		deleteScene();
+
+		return success ? 0 : 1;
+	}
+
+	// render without window
+	if(g_options.headless())
+	{
+		// tiles are encoded and written on an own thread while the next ones are rendered
+		ITileOutput *output = createTileOutput(g_options.output);
+		if(g_options.asyncOutput)output = new AsyncTileOutput(output);
+
+		bool success = false;
+
+		if(g_options.coordinatorPort)success = RunCoordinator((unsigned short)g_options.coordinatorPort, *output);
+		else if(g_options.tiled)success = RenderTiled(*output);
+		else if(g_options.pipeline && !g_options.progressive)
+		{
+			// composited tiles go out while the others are still rendered
+			if(output->begin(g_width, g_height))
+			{
+				RenderPipelined(output);
+				success = output->end();
+			}
+		}
+		else
+		{
+			if(g_options.progressive)RenderProgressive();
+			else RenderMain();
+
+			// write whole image as one tile
+			if(output->begin(g_width, g_height))
+			{
+				output->writeTile(Tile(0, 0, g_width, g_height), g_final);
+				success = output->end();
+			}
+
+			if(g_options.aoOutputs)
+			{
+				success &= writePPM(outputName(g_options.output, "bent"), g_bentnormals);
+				success &= writePPM(outputName(g_options.output, "unoccluded"), g_unoccluded);
+				success &= writePPM(outputName(g_options.output, "obscurance"), g_obscurance);
+			}
+		}
+
+		// where the frame was expensive
+		for(unsigned int i = 0; i < heatmaps.size(); i++)
+		{
+			g_costMap.toImage(heatmaps[i], g_heatmap);
+			writePPM(outputName(g_options.output, string("heat_") + costMetricName(heatmaps[i])), g_heatmap);
+
+			cout<<"heatmap of "<<costMetricName(heatmaps[i])<<", red is "<<g_costMap.getScale(heatmaps[i])<<" per pixel"<<endl;
+			g_costMap.printTiles(cout, heatmaps[i], g_options.tileSize, 5);
+		}
+
+		delete output;
+
+		ReportStats();
+		deleteScene();
+
+		return success ? 0 : 1;
+	}
+
+	// black until the costs are complete
+	if(g_costMap.enabled())g_heatmap.create(g_width, g_height);
+
 	// start thread
-	boost::thread renderThread(RenderMain);
+	boost::thread renderThread(RenderThread);
 	
 	// init glfw
 	glfwInit();
@@ -570,23 +1313,29 @@ int main(int argc, char * argv[])
 	glfwOpenWindow(g_width, g_height, 8, 8, 8, 8, 0, 0, GLFW_WINDOW);
 	glfwSetWindowTitle("Object Space Ambient Occlusion");
 	
+	// metric shown in the heatmap mode and whether its image is made from the final costs yet
+	CostMetric heatMetric = COST_TIME;
+	bool heatDone = true;
+
 	// loop till end
 	bool running = true;
 	while(running)
 	{
 		
 		//lock mutexes
-		img_mutex.lock();
-		ao_mutex.lock();
-		norm_mutex.lock();
-		invao_mutex.lock();
-		final_mutex.lock();
+		traceLock(img_mutex, "img_mutex");
+		traceLock(ao_mutex, "ao_mutex");
+		traceLock(norm_mutex, "norm_mutex");
+		traceLock(invao_mutex, "invao_mutex");
+		traceLock(final_mutex, "final_mutex");
+		traceLock(aoext_mutex, "aoext_mutex");
 
 		Draw();
 		
 		// swap buffers
 		glfwSwapBuffers();
 
+		aoext_mutex.unlock();
 		final_mutex.unlock();
 		invao_mutex.unlock();
 		norm_mutex.unlock();
@@ -594,11 +1343,38 @@ int main(int argc, char * argv[])
 		img_mutex.unlock();		
 
 		// switch render modes...
-		if(glfwGetKey(GLFW_KEY_F1)){mode = 0; img_mutex.lock(); g_image.forceupdate(); img_mutex.unlock();}
-		if(glfwGetKey(GLFW_KEY_F3)){mode = 1; ao_mutex.lock(); g_aopass.forceupdate(); ao_mutex.unlock();}
-		if(glfwGetKey(GLFW_KEY_F2)){mode = 2; norm_mutex.lock(); g_normals.forceupdate(); norm_mutex.unlock();}
-		if(glfwGetKey(GLFW_KEY_F4)){mode = 3; invao_mutex.lock(); g_invao.forceupdate(); invao_mutex.unlock();}
-		if(glfwGetKey(GLFW_KEY_F5)){mode = 4; final_mutex.lock(); g_final.forceupdate(); final_mutex.unlock();}
+		if(glfwGetKey(GLFW_KEY_F1)){mode = 0; traceLock(img_mutex, "img_mutex"); g_image.forceupdate(); img_mutex.unlock();}
+		if(glfwGetKey(GLFW_KEY_F3)){mode = 1; traceLock(ao_mutex, "ao_mutex"); g_aopass.forceupdate(); ao_mutex.unlock();}
+		if(glfwGetKey(GLFW_KEY_F2)){mode = 2; traceLock(norm_mutex, "norm_mutex"); g_normals.forceupdate(); norm_mutex.unlock();}
+		if(glfwGetKey(GLFW_KEY_F4)){mode = 3; traceLock(invao_mutex, "invao_mutex"); g_invao.forceupdate(); invao_mutex.unlock();}
+		if(glfwGetKey(GLFW_KEY_F5)){mode = 4; traceLock(final_mutex, "final_mutex"); g_final.forceupdate(); final_mutex.unlock();}
+
+		// further ambient occlusion outputs
+		if(g_options.aoOutputs)
+		{
+			if(glfwGetKey(GLFW_KEY_F6)){mode = 5; traceLock(aoext_mutex, "aoext_mutex"); g_bentnormals.forceupdate(); aoext_mutex.unlock();}
+			if(glfwGetKey(GLFW_KEY_F7)){mode = 6; traceLock(aoext_mutex, "aoext_mutex"); g_unoccluded.forceupdate(); aoext_mutex.unlock();}
+			if(glfwGetKey(GLFW_KEY_F8)){mode = 7; traceLock(aoext_mutex, "aoext_mutex"); g_obscurance.forceupdate(); aoext_mutex.unlock();}
+		}
+
+		// render cost, the heatmap is only used by this thread. the render threads write the costs
+		// without locking, so they are read once the frame is done
+		if(g_costMap.enabled())
+		{
+			if(glfwGetKey(GLFW_KEY_F9)){mode = 8; heatMetric = COST_TIME; heatDone = false;}
+			if(glfwGetKey(GLFW_KEY_F10)){mode = 8; heatMetric = COST_RAYS; heatDone = false;}
+			if(glfwGetKey(GLFW_KEY_F11)){mode = 8; heatMetric = COST_TESTS; heatDone = false;}
+
+			done_mutex.lock();
+			bool renderDone = g_renderDone;
+			done_mutex.unlock();
+
+			if(!heatDone && renderDone)
+			{
+				g_costMap.toImage(heatMetric, g_heatmap);
+				heatDone = true;
+			}
+		}
 
 		// if ESC or window closed terminate
 		running = ! glfwGetKey(GLFW_KEY_ESC) && glfwGetWindowParam(GLFW_OPENED);
@@ -610,6 +1386,8 @@ int main(int argc, char * argv[])
 	// wait for render thread
 	renderThread.join();
 
+	ReportStats();
+
 	// delete objects
 	deleteScene();
 
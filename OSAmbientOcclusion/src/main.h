@@ -11,6 +11,7 @@
 // needs boost & glfw installed to compile properly
 
 #include <iostream>
+#include <fstream>
 #include <boost/thread.hpp>
 #include <gl/glfw.h>
 #include <ctime>
@@ -23,21 +24,191 @@
 #include "Camera.h"
 #include "Lights.h"
 #include "Matrix.h"
+#include "Instance.h"
+#include "Stats.h"
+#include "Random.h"
+#include "Parallel.h"
+#include "GBuffer.h"
+#include "SceneIO.h"
+#include "Options.h"
+#include "Tiles.h"
+#include "TileOutput.h"
+#include "Accelerator.h"
+#include "LightGrid.h"
+#include "SharedFramebuffer.h"
+#include "CostMap.h"
+#include "Trace.h"
+#include "AnalyticAO.h"
+#include "SurfelAO.h"
 
-// size of render window
+// default size of render window, can be changed on the command line
 
 #ifdef _DEBUG
-static const int g_width = 10;
-static const int g_height = 10;
+#define DEFAULT_WIDTH 10
+#define DEFAULT_HEIGHT 10
 #else
-static const int g_width = 300;
-static const int g_height = 300;
+#define DEFAULT_WIDTH 300
+#define DEFAULT_HEIGHT 300
 #endif
 
-/// float random function
-float random(float fmin, float fmax)
+// size of render window
+extern int g_width;
+extern int g_height;
+
+// working set of a single tile, reused for all tiles of an image
+struct TileBuffers
 {
-	return fmin + (((float)(rand()%RAND_MAX) / (float)RAND_MAX)) * (fmax - fmin);
-}
+	GBuffer	gbuffer;
+
+	/// antialiased color
+	Image	image;
+
+	/// ambient occlusion, including a border for the blur
+	Image	aopass;
+
+	/// inverse blurred ambient occlusion
+	Image	invao;
+
+	/// composited tile
+	Image	final;
+
+	/// (re)allocate buffers if tile size changed
+	void resize(const int width, const int height, const int border)
+	{
+		if(image.getWidth() == width && image.getHeight() == height)return;
+
+		gbuffer.create(width, height);
+		image.create(width, height);
+		aopass.create(width + 2 * border, height + 2 * border);
+		invao.create(width, height);
+		final.create(width, height);
+	}
+};
+
+// shared between the render modes, defined in main.cpp
+
+// command line settings
+extern RenderOptions g_options;
+
+// list of scene objects
+extern std::vector<IObject*> g_objects;
+
+// list of scene lights
+extern std::vector<ILight*> g_lights;
+
+// camera
+extern Camera g_camera;
+
+// full size buffers, only used if not rendering tiles
+extern GBuffer g_GBuffer;
+extern Image g_image;
+extern Image g_normals;
+extern Image g_aopass;
+extern Image g_invao;
+extern Image g_final;
+
+// further ambient occlusion outputs, only filled if g_options.aoOutputs is set
+extern Image g_bentnormals;
+extern Image g_unoccluded;
+extern Image g_obscurance;
+
+// memory mapped copy of g_final for other processes, does nothing unless opened
+extern SharedFramebuffer g_sharedFramebuffer;
+
+// render cost of each pixel, only recorded if heatmaps were requested
+extern CostMap g_costMap;
+
+// guard the images shown by the viewer
+extern boost::mutex img_mutex;
+extern boost::mutex norm_mutex;
+extern boost::mutex ao_mutex;
+extern boost::mutex invao_mutex;
+extern boost::mutex final_mutex;
+extern boost::mutex aoext_mutex;
+
+// acceleration structures for camera rays and ambient occlusion rays
+extern IAccelerator *g_primaryAccel;
+extern IAccelerator *g_aoAccel;
+
+// closed form ambient occlusion, NULL unless --ao-method analytic
+extern AnalyticAO *g_analyticAO;
+
+// disk based ambient occlusion, NULL unless --ao-method surfels
+extern SurfelAO *g_surfelAO;
+
+// culling structure for g_lights
+extern LightGrid g_lightGrid;
+
+/// camera of the demo scene for the current image size
+void setupCamera();
+
+void deleteScene();
+
+/// (re)build acceleration structures and the light grid after the scene was changed, returns false if a structure is unknown
+bool buildAccelerators();
+
+/// set image size and allocate full size images and GBuffer
+void createImages(const int width, const int height);
+
+/// render all passes of the full size images
+void RenderMain();
+
+/// raytrace color and GBuffer of the full size image
+void Raytrace();
+
+/// depth image of the GBuffer, shown instead of the normals
+void DepthPass();
+
+/// ambient occlusion of the full size image into g_aopass
+void AmbientOcclusionPass();
+
+/// blur g_aopass and composite it with the color into g_final
+void CompositePass();
+
+/// shaded color of the nearest hit, normal and point are set to the hit(point is far away if nothing was hit)
+Color traceRay(const Ray& r, Vector& normal, Vector& point);
+
+/// like traceRay, but the hit is stored as pixel(x, y) of gbuffer
+Color traceGBuffer(GBuffer& gbuffer, const int x, const int y, const Ray& r, Vector& normal);
+
+/// antialiased color of a pixel, average of grid_size x grid_size rays
+Color traceGrid(const int x, const int y, const int grid_size);
+
+/// tangent and binormal completing normal to an orthonormal basis
+void hemisphereBasis(const Vector& normal, Vector& tangent, Vector& binormal);
+
+/// fraction of samples random hemisphere rays around normal that hit an object within the ao radius
+float computeAO(const Vector& point, const Vector& normal, const int samples);
+
+/// all outputs of the ambient occlusion kernel for one point, computed from the same rays
+struct AOSample
+{
+	/// fraction of occluded rays, the same value computeAO returns
+	float	occlusion;
+
+	/// occlusion weighted by 1 - distance / ao radius, near objects occlude more than distant ones
+	float	obscurance;
+
+	/// mean of all unoccluded directions, shorter the more the free directions are spread
+	Vector	unoccluded;
+
+	/// normalized mean unoccluded direction, the normal itself if every ray is occluded
+	Vector	bentNormal;
+
+	AOSample():occlusion(0.0f), obscurance(0.0f)	{}
+};
+
+/// ambient occlusion, obscurance, bent normal and mean unoccluded direction of samples random hemisphere rays.
+/// rays look for the nearest hit instead of any hit, so each is a bit more expensive than in computeAO
+AOSample computeAOSample(const Vector& point, const Vector& normal, const int samples);
+
+/// store an ambient occlusion sample in g_aopass and the further outputs, ao_mutex and aoext_mutex have to be locked
+void setAOPixel(const int x, const int y, const AOSample& sample);
+
+/// raytrace and ambient occlusion of a single tile, fills buffers.gbuffer, buffers.image and buffers.aopass
+void TraceTile(const Tile& tile, TileBuffers& buffers);
+
+/// blur, invert and composite a traced tile, result is stored in buffers.final
+void CompositeTile(const Tile& tile, TileBuffers& buffers);
 
 #endif
\ No newline at end of file